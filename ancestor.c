@@ -0,0 +1,587 @@
+/*
+ * Life search program - ancestor search routines.
+ * The ancestors of the last generation are found one generation back at
+ * a time.  The parents of the last generation are found by the column
+ * sweep of the parent search, then the parents of each of those, and so
+ * on back to generation 0.  Only a limited number of the parents of each
+ * pattern are tried, so that the search does not get stuck on the first
+ * pattern.  Each pattern is only explored once, counting its flipped
+ * images as the same pattern.  Patterns which are proved to have no
+ * ancestors far enough back can be remembered in a file, so that later
+ * runs do not explore them again.
+ */
+
+#include "lifesrc.h"
+
+
+#define	KNOWN_HASH	(1L << 16)	/* size of explored pattern hash table */
+#define	FILE_MAGIC	"lifesrc ancestors"	/* first word of file */
+#define	FILE_LINE	(COL_MAX * 17 + 80)	/* size of lines in file */
+
+
+/*
+ * A pattern which has been explored, as the columns of its canonical
+ * flipped image.  If proved, it has no ancestors the given number of
+ * generations back.  Otherwise it was explored as far as the limit on
+ * parents allowed.
+ */
+typedef	struct Known	Known;
+
+struct Known
+{
+	Known *	next;		/* next pattern in hash chain */
+	int	gens;		/* generations back which were explored */
+	Bool	proved;		/* pattern has no ancestors */
+	RowBits	cols[1];	/* columns of pattern */
+};
+
+
+static	Known **	hashTable;	/* explored patterns */
+static	RowBits		pattern[GEN_MAX][COL_MAX + 2];	/* patterns being followed */
+static	RowBits		knownCols[GEN_MAX][COL_MAX + 2];	/* cells known at start */
+static	RowBits		knownMasks[GEN_MAX][COL_MAX + 2];	/* which cells are known */
+static	RowBits *	parentList[GEN_MAX];	/* parents of each pattern */
+static	long		parentCount[GEN_MAX];	/* number of parents */
+static	long		parentMax[GEN_MAX];	/* allocated number of parents */
+static	long		parentIndex[GEN_MAX];	/* parent being followed */
+static	Bool		cutOff[GEN_MAX];	/* some parents were not tried */
+static	Bool		foundAny[GEN_MAX];	/* some ancestor was found */
+static	Bool		lastKnown;	/* last generation is completely known */
+static	Bool		useFlips;	/* flipped patterns count as the same */
+static	Bool		anyDepth;	/* proofs hold for more generations back */
+static	FILE *		knownFile;	/* file of patterns with no ancestors */
+static	int		colWords;	/* words in the columns of a pattern */
+static	int		level;		/* generation whose parents are followed */
+static	Bool		started;	/* search has been started */
+
+
+/*
+ * Local procedures
+ */
+static	void	initAncestors(void);
+static	void	findParents(int, const RowBits *);
+static	void	finishPattern(int);
+static	void	canonical(const RowBits *, RowBits *);
+static	RowBits	flipColumn(RowBits);
+static	Known *	findKnown(const RowBits *, Bool);
+static	void	openKnownFile(void);
+static	void	showAncestors(void);
+
+
+/*
+ * Search for an ancestor in generation 0 of the last generation.
+ * Returns FOUND with the ancestor and the generations between set in
+ * the cells, or NOT_EXIST when there are no more ancestors to try.
+ * Further calls continue the search.
+ */
+Status
+ancestorSearch(void)
+{
+	RowBits	canon[COL_MAX + 2];
+	Known *	known;
+	int	gens;
+
+	if (started)
+		parentIndex[level]++;
+	else
+	{
+		started = TRUE;
+		initAncestors();
+		level = genMax - 1;
+	}
+
+	while (level < genMax)
+	{
+		if (parentIndex[level] >= parentCount[level])
+		{
+			finishPattern(level);
+
+			if (level == genMax - 1)
+				return NOT_EXIST;
+
+			cutOff[level + 1] |= cutOff[level];
+			foundAny[level + 1] |= foundAny[level];
+			level++;
+			parentIndex[level]++;
+			continue;
+		}
+
+		memcpy(pattern[level - 1],
+			&parentList[level][parentIndex[level] * colWords],
+			colWords * sizeof(RowBits));
+
+		if (viewFreq && (++viewCount >= viewFreq))
+		{
+			viewCount = 0;
+			ttyStatus("Generation %d, parent %ld of %ld\n",
+				level, parentIndex[level] + 1, parentCount[level]);
+		}
+
+		if (level == 1)
+		{
+			foundAny[level] = TRUE;
+			showAncestors();
+
+			return FOUND;
+		}
+
+		/*
+		 * Skip a parent which was explored before, or which is
+		 * known to have no ancestors far enough back.  A parent
+		 * which was explored without a proof stops this pattern
+		 * being proved.
+		 */
+		gens = level - 1;
+		canonical(pattern[level - 1], canon);
+		known = findKnown(canon, FALSE);
+
+		if (known && known->proved && ((known->gens == gens) ||
+			(anyDepth && (known->gens < gens))))
+		{
+			parentIndex[level]++;
+			continue;
+		}
+
+		if (known && (known->gens == gens))
+		{
+			cutOff[level] = TRUE;
+			parentIndex[level]++;
+			continue;
+		}
+
+		level--;
+		findParents(level, pattern[level]);
+	}
+
+	return NOT_EXIST;
+}
+
+
+/*
+ * Get the last generation from the cells, remember which cells of the
+ * earlier generations are known, read the file of patterns with no
+ * ancestors, and find the parents of the last generation.  The known
+ * cells are remembered here because the cells are changed to show each
+ * ancestor which is found.
+ */
+static void
+initAncestors(void)
+{
+	RowBits	mask[COL_MAX + 2];
+	RowBits	canon[COL_MAX + 2];
+	RowBits	allRows;
+	Known *	known;
+	Cell *	cell;
+	int	row;
+	int	col;
+	int	gen;
+
+	colWords = colMax + 2;
+	allRows = (1ULL << (rowMax + 2)) - 1;
+
+	hashTable = (Known **) calloc(KNOWN_HASH, sizeof(Known *));
+
+	if (hashTable == NULL)
+		fatal("Cannot allocate ancestor table");
+
+	/*
+	 * Flipped patterns only have the same ancestors if none of the
+	 * cells of the earlier generations are already known.
+	 */
+	useFlips = TRUE;
+
+	for (gen = 0; gen < genMax - 1; gen++)
+	{
+		cellColumns(gen, knownCols[gen], knownMasks[gen]);
+
+		for (row = 1; row <= rowMax; row++)
+		{
+			for (col = 1; col <= colMax; col++)
+			{
+				cell = findCell(row, col, gen);
+
+				if (cell->state != UNK)
+					useFlips = FALSE;
+			}
+		}
+	}
+
+	cellColumns(genMax - 1, pattern[genMax - 1], mask);
+	lastKnown = TRUE;
+
+	for (col = 0; col <= colMax + 1; col++)
+	{
+		if (mask[col] != allRows)
+			lastKnown = FALSE;
+	}
+
+	/*
+	 * A proof for fewer generations back also holds for more only if
+	 * no cells of the generations between are known, and if the -mc
+	 * and -wc limits are not in use, since they only applied to the
+	 * generation which was then the earliest one.
+	 */
+	anyDepth = (useFlips && (colCells == 0) && (colWidth == 0));
+
+	if (ancestorFile && useFlips)
+		openKnownFile();
+
+	/*
+	 * The last generation may already be known to have no ancestors.
+	 */
+	if (lastKnown)
+	{
+		canonical(pattern[genMax - 1], canon);
+		known = findKnown(canon, FALSE);
+
+		if (known && known->proved && ((known->gens == genMax - 1) ||
+			(anyDepth && (known->gens < genMax - 1))))
+		{
+			parentCount[genMax - 1] = 0;
+			cutOff[genMax - 1] = FALSE;
+
+			return;
+		}
+	}
+
+	if (!startParents(genMax - 2, pattern[genMax - 1], mask,
+		knownCols[genMax - 2], knownMasks[genMax - 2]))
+	{
+		parentCount[genMax - 1] = 0;
+		cutOff[genMax - 1] = FALSE;
+
+		return;
+	}
+
+	findParents(genMax - 1, NULL);
+}
+
+
+/*
+ * Find the parents of the pattern of the specified generation, up to
+ * the limit on the number of parents.  If the pattern is NULL, then the
+ * parents have already been started.
+ */
+static void
+findParents(int gen, const RowBits * cols)
+{
+	RowBits	mask[COL_MAX + 2];
+	int	col;
+
+	parentCount[gen] = 0;
+	parentIndex[gen] = 0;
+	cutOff[gen] = FALSE;
+	foundAny[gen] = FALSE;
+
+	if (cols)
+	{
+		for (col = 0; col <= colMax + 1; col++)
+			mask[col] = (1ULL << (rowMax + 2)) - 1;
+
+		if (!startParents(gen - 1, cols, mask, knownCols[gen - 1],
+			knownMasks[gen - 1]))
+			return;
+	}
+
+	for (;;)
+	{
+		if (parentCount[gen] >= parentMax[gen])
+		{
+			parentMax[gen] = parentMax[gen] * 2 + 64;
+			parentList[gen] = (RowBits *) realloc(parentList[gen],
+				parentMax[gen] * colWords * sizeof(RowBits));
+
+			if (parentList[gen] == NULL)
+				fatal("Cannot allocate parent list");
+		}
+
+		if (!nextParent(&parentList[gen][parentCount[gen] * colWords]))
+			return;
+
+		if (ancestorBreadth && (parentCount[gen] >= ancestorBreadth))
+		{
+			cutOff[gen] = TRUE;
+
+			return;
+		}
+
+		parentCount[gen]++;
+	}
+}
+
+
+/*
+ * Remember that the pattern of the specified generation has been
+ * explored.  If every one of its parents was tried without finding an
+ * ancestor, then it is proved to have none, and is added to the file.
+ */
+static void
+finishPattern(int gen)
+{
+	RowBits	canon[COL_MAX + 2];
+	Known *	known;
+	Bool	proved;
+	int	col;
+
+	if ((gen == genMax - 1) && !lastKnown)
+		return;
+
+	/*
+	 * A proof about more generations back is kept.
+	 */
+	proved = (!foundAny[gen] && !cutOff[gen]);
+	canonical(pattern[gen], canon);
+	known = findKnown(canon, TRUE);
+
+	if (known->proved && !proved)
+		return;
+
+	known->gens = gen;
+	known->proved = proved;
+
+	if (!proved || (knownFile == NULL))
+		return;
+
+	fprintf(knownFile, "N %d", gen);
+
+	for (col = 1; col <= colMax; col++)
+		fprintf(knownFile, " %llx", canon[col]);
+
+	fprintf(knownFile, "\n");
+	fflush(knownFile);
+}
+
+
+/*
+ * Get the canonical image of a pattern, which is the smallest of its
+ * images flipped around the middle row and the middle column.
+ */
+static void
+canonical(const RowBits * cols, RowBits * canon)
+{
+	RowBits	image[COL_MAX + 2];
+	int	flip;
+	int	col;
+
+	memcpy(canon, cols, colWords * sizeof(RowBits));
+
+	for (flip = 1; useFlips && (flip < 4); flip++)
+	{
+		image[0] = 0;
+		image[colMax + 1] = 0;
+
+		for (col = 1; col <= colMax; col++)
+		{
+			image[col] = cols[(flip & 1) ? (colMax + 1 - col) : col];
+
+			if (flip & 2)
+				image[col] = flipColumn(image[col]);
+		}
+
+		for (col = 1; col <= colMax; col++)
+		{
+			if (image[col] != canon[col])
+				break;
+		}
+
+		if ((col <= colMax) && (image[col] < canon[col]))
+			memcpy(canon, image, colWords * sizeof(RowBits));
+	}
+}
+
+
+/*
+ * Return a column flipped around the middle row.
+ */
+static RowBits
+flipColumn(RowBits bits)
+{
+	RowBits	flipped;
+	int	row;
+
+	flipped = 0;
+
+	for (row = 1; row <= rowMax; row++)
+	{
+		if (bits & (1ULL << row))
+			flipped |= (1ULL << (rowMax + 1 - row));
+	}
+
+	return flipped;
+}
+
+
+/*
+ * Find an explored pattern given its canonical columns, adding it if
+ * it is not there and that is wanted.  Returns NULL if it is not found.
+ */
+static Known *
+findKnown(const RowBits * cols, Bool add)
+{
+	unsigned long long	hash;
+	Known *			known;
+	int			col;
+
+	hash = 0;
+
+	for (col = 1; col <= colMax; col++)
+		hash = (hash ^ cols[col]) * 0x9e3779b97f4a7c15ULL;
+
+	hash = (hash >> 32) % KNOWN_HASH;
+
+	for (known = hashTable[hash]; known; known = known->next)
+	{
+		if (memcmp(known->cols, cols, colWords * sizeof(RowBits)) == 0)
+			return known;
+	}
+
+	if (!add)
+		return NULL;
+
+	known = (Known *) malloc(sizeof(Known) +
+		(colWords - 1) * sizeof(RowBits));
+
+	if (known == NULL)
+		fatal("Cannot allocate explored pattern");
+
+	memcpy(known->cols, cols, colWords * sizeof(RowBits));
+	known->gens = 0;
+	known->proved = FALSE;
+	known->next = hashTable[hash];
+	hashTable[hash] = known;
+
+	return known;
+}
+
+
+/*
+ * Read the patterns with no ancestors from the file, and open it for
+ * adding more of them.  The first line of the file gives the size of
+ * the search area, the limits on columns, and the rules, and the file
+ * is not used if these are different.
+ */
+static void
+openKnownFile(void)
+{
+	static	char	buf[FILE_LINE];
+	char		header[FILE_LINE];
+	RowBits		cols[COL_MAX + 2];
+	Known *		known;
+	FILE *		fp;
+	Bool		empty;
+	char *		cp;
+	int		gens;
+	int		col;
+	int		i;
+
+	cp = header;
+	cp += sprintf(cp, "%s %d %d %d %d ", FILE_MAGIC, rowMax, colMax,
+		colCells, colWidth);
+
+	for (i = 0; i < 512; i += 4)
+	{
+		*cp++ = "0123456789abcdef"[ruleTable[i] + ruleTable[i + 1] * 2 +
+			ruleTable[i + 2] * 4 + ruleTable[i + 3] * 8];
+	}
+
+	strcpy(cp, "\n");
+
+	fp = fopen(ancestorFile, "r");
+	empty = ((fp == NULL) || (fgets(buf, FILE_LINE, fp) == NULL));
+
+	if (!empty && strcmp(buf, header))
+	{
+		ttyStatus("Ancestor file \"%s\" is for other settings\n",
+			ancestorFile);
+		fclose(fp);
+
+		return;
+	}
+
+	if (fp)
+	{
+		while (fgets(buf, FILE_LINE, fp))
+		{
+			if (buf[0] != 'N')
+				continue;
+
+			cp = &buf[1];
+			gens = (int) strtol(cp, &cp, 10);
+			cols[0] = 0;
+			cols[colMax + 1] = 0;
+
+			for (col = 1; col <= colMax; col++)
+				cols[col] = strtoull(cp, &cp, 16);
+
+			known = findKnown(cols, TRUE);
+
+			if (!known->proved || (gens < known->gens))
+				known->gens = gens;
+
+			known->proved = TRUE;
+		}
+
+		fclose(fp);
+	}
+
+	knownFile = fopen(ancestorFile, "a");
+
+	if (knownFile == NULL)
+	{
+		ttyStatus("Cannot write ancestor file \"%s\"\n", ancestorFile);
+
+		return;
+	}
+
+	if (empty)
+	{
+		fputs(header, knownFile);
+		fflush(knownFile);
+	}
+}
+
+
+/*
+ * Set the cells of every generation from the ancestor which was found.
+ * The last generation is made from the one before it, since some of its
+ * cells may not have been known.
+ */
+static void
+showAncestors(void)
+{
+	Cell *	cell;
+	int	gen;
+	int	row;
+	int	col;
+
+	cellCount = 0;
+
+	for (gen = 0; gen < genMax; gen++)
+	{
+		for (col = 1; col <= colMax; col++)
+		{
+			for (row = 1; row <= rowMax; row++)
+			{
+				cell = findCell(row, col, gen);
+
+				if (gen < genMax - 1)
+				{
+					cell->state = ((pattern[gen][col] >> row) & 1)
+						? ON : OFF;
+				}
+				else
+				{
+					cell->state = ruleTable[ruleIndex(
+						pattern[gen - 1][col - 1],
+						pattern[gen - 1][col],
+						pattern[gen - 1][col + 1], row)];
+				}
+
+				if ((gen == 0) && (cell->state == ON))
+					cellCount++;
+			}
+		}
+	}
+}
+
+/* END CODE */
@@ -0,0 +1,680 @@
+/*
+ * Life search program - column frontier search routines.
+ * Spaceships which translate columns are built one column at a time,
+ * in the style of Dean Hickerson's row by row searches.  A cell of the
+ * next generation is known from the three columns of the previous
+ * generation around it, so the columns of all generations are added in
+ * an interleaved order in which each new column is checked against the
+ * two previous columns of its generation and the newest column of the
+ * next generation.  Only these last two columns of each generation (the
+ * frontier) can affect how a partial spaceship is extended, so the
+ * distinct frontiers are kept in a breadth first queue, and a spaceship
+ * is found whenever a frontier becomes empty again.
+ */
+
+#include "lifesrc.h"
+
+
+#define	FRONT_WORDS	(GEN_MAX * 2)	/* column words in a frontier */
+#define	NO_FRONT	(-1L)		/* index of no frontier */
+
+
+/*
+ * A frontier reached by extending its parent frontier.  The newest
+ * column of generation G is in word G*2, and the previous one is in
+ * word G*2+1.
+ */
+typedef	struct
+{
+	long	parent;			/* index of parent frontier */
+	int	depth;			/* number of steps from the start */
+	RowBits	words[FRONT_WORDS];	/* columns of the frontier */
+} Front;
+
+
+/*
+ * The frontiers are numbered in the order they were made.  The newest
+ * ones are kept in memory, and older ones are written to a file when
+ * memory is full.  Only the frontiers in memory are checked for being
+ * duplicates.
+ */
+static	Front *	frontTable;	/* frontiers kept in memory */
+static	long	frontBase;	/* index of first frontier in memory */
+static	long	frontCount;	/* number of frontiers made */
+static	long	frontLimit;	/* number of frontiers which fit in memory */
+static	long	frontHead;	/* index of next frontier to extend */
+static	long	levelEnd;	/* index of end of the current step */
+static	FILE *	spillFile;	/* frontiers which did not fit in memory */
+static	long *	hashTable;	/* indexes of frontiers in memory */
+static	long	hashSize;	/* size of hash table (power of two) */
+static	int	frontWords;	/* number of words used in a frontier */
+static	int	stepCols;	/* number of columns added by each step */
+static	int	phases;		/* number of steps which add one column */
+static	int	colOffset;	/* offset to make all columns positive */
+static	Front	curFront;	/* frontier being extended */
+static	Front	newFront;	/* frontier being made */
+static	Bool	closed;		/* frontier can close off a spaceship */
+
+
+/*
+ * The generations whose columns are added by the current step, and the
+ * lists of the possible new columns for each of them.
+ */
+static	int	stepGens[GEN_MAX];	/* generations of the new columns */
+static	int	stepCount;	/* number of new columns */
+static	RowBits *	colList[GEN_MAX];	/* possible new columns */
+static	int	colListCount[GEN_MAX];	/* number of possible columns */
+static	int	colListMax[GEN_MAX];	/* allocated size of lists */
+
+
+/*
+ * Local procedures
+ */
+static	void	initFront(void);
+static	Bool	stepColumn(int, int, int *);
+static	void	extendFront(void);
+static	void	addColumn(RowBits);
+static	void	addFronts(int);
+static	void	addFront(void);
+static	void	readFront(long, Front *);
+static	long	findFront(const Front *);
+static	void	hashFronts(void);
+static	void	spillFronts(void);
+static	void	pruneStep(void);
+static	int	frontCells(const Front *);
+static	int	frontSortFunc(const void *, const void *);
+static	void	showShip(void);
+
+
+/*
+ * Search for a spaceship by extending frontiers breadth first.
+ * Returns FOUND with the spaceship set in the cells, or NOT_EXIST
+ * when there are no more frontiers to extend.  Further calls continue
+ * the search.
+ */
+Status
+frontierSearch(void)
+{
+	if (frontTable == NULL)
+		initFront();
+
+	while (frontHead < frontCount)
+	{
+		/*
+		 * When all of the frontiers of a step have been made,
+		 * keep only the best of them if the queue is limited.
+		 */
+		if (frontHead == levelEnd)
+		{
+			if (frontBeam)
+				pruneStep();
+
+			levelEnd = frontCount;
+		}
+
+		readFront(frontHead, &curFront);
+
+		closed = FALSE;
+		extendFront();
+		frontHead++;
+
+		if (viewFreq && (++viewCount >= viewFreq))
+		{
+			viewCount = 0;
+			ttyStatus("Step %d, %ld frontiers queued\n",
+				curFront.depth, frontCount - frontHead);
+		}
+
+		if (ttyCheck())
+			getCommands();
+
+		if (closed)
+		{
+			showShip();
+
+			return FOUND;
+		}
+	}
+
+	return NOT_EXIST;
+}
+
+
+/*
+ * Allocate the tables and queue the empty frontier.
+ * Generation G of column C is ordered by the value G*T + C*P for the
+ * translation T and the period P.  A cell of generation G+1 then comes
+ * T after the cell of generation G which makes it, and the wrap from the
+ * last generation to generation 0 fits in since generation P of column C
+ * is generation 0 of column C+T.  Each step adds the columns for the next
+ * multiple of the greatest common divisor of T and P, and the search
+ * starts with all of the columns before column 1 of generation 0 known
+ * to be empty.
+ */
+static void
+initFront(void)
+{
+	long	size;
+	int	step;
+	int	gen;
+	int	col;
+	int	tmp;
+
+	size = frontMemory ? frontMemory : FRONT_MEMORY;
+	frontLimit = (size * 1024L * 1024L) / (long) sizeof(Front);
+
+	if (frontLimit < 2)
+		frontLimit = 2;
+
+	hashSize = 1;
+
+	while (hashSize < frontLimit * 2)
+		hashSize *= 2;
+
+	frontTable = (Front *) malloc(frontLimit * sizeof(Front));
+	hashTable = (long *) malloc(hashSize * sizeof(long));
+
+	if ((frontTable == NULL) || (hashTable == NULL))
+		fatal("Cannot allocate frontier tables");
+
+	stepCols = colTrans;
+	tmp = genMax;
+
+	while (tmp)
+	{
+		col = stepCols % tmp;
+		stepCols = tmp;
+		tmp = col;
+	}
+
+	phases = genMax / stepCols;
+	frontWords = genMax * 2;
+
+	/*
+	 * Find the offset which makes the first column of every
+	 * generation positive.
+	 */
+	colOffset = 0;
+
+	for (step = 1; step <= phases; step++)
+	{
+		for (gen = 0; gen < genMax; gen++)
+		{
+			if (stepColumn(step, gen, &col) &&
+				(col + colOffset < 1))
+			{
+				colOffset = 1 - col;
+			}
+		}
+	}
+
+	memset(&frontTable[0], 0, sizeof(Front));
+	frontTable[0].parent = NO_FRONT;
+	frontTable[0].depth = 0;
+
+	frontBase = 0;
+	frontCount = 1;
+	frontHead = 0;
+	levelEnd = 0;
+
+	hashFronts();
+}
+
+
+/*
+ * Return whether the specified step adds a column of the specified
+ * generation, and if so which column it is.
+ */
+static Bool
+stepColumn(int step, int gen, int * col)
+{
+	int	value;
+
+	value = genMax + (step - 1) * stepCols - gen * colTrans;
+
+	if (value % genMax)
+		return FALSE;
+
+	*col = value / genMax;
+
+	return TRUE;
+}
+
+
+/*
+ * Find all of the ways of extending the current frontier by one step.
+ * The possible new columns for each generation of the step are looked
+ * up separately since they do not affect each other, and then every
+ * combination of them is added.
+ */
+static void
+extendFront(void)
+{
+	const RowBits *	list;
+	RowBits		leftCol;
+	RowBits		midCol;
+	RowBits		nextCol;
+	RowBits		allRows;
+	int		count;
+	int		gen;
+	int		col;
+	int		i;
+
+	newFront = curFront;
+	newFront.parent = frontHead;
+	newFront.depth = curFront.depth + 1;
+	stepCount = 0;
+	allRows = (1ULL << (rowMax + 2)) - 1;
+
+	for (gen = 0; gen < genMax; gen++)
+	{
+		if (!stepColumn(newFront.depth, gen, &col))
+			continue;
+
+		leftCol = curFront.words[gen * 2 + 1];
+		midCol = curFront.words[gen * 2];
+		nextCol = curFront.words[((gen + 1) % genMax) * 2];
+
+		stepGens[stepCount] = gen;
+		colListCount[stepCount] = 0;
+		newFront.words[gen * 2 + 1] = midCol;
+
+		list = findColumns(1, &leftCol, &midCol, nextCol, allRows,
+			0, &count);
+
+		/*
+		 * Cells beyond the last column are not allowed, and the
+		 * columns of generation 0 must fit the column limits.
+		 */
+		for (i = 0; i < count; i++)
+		{
+			if ((col + colOffset > colMax) && list[i])
+				continue;
+
+			if ((gen == 0) && !columnFits(list[i]))
+				continue;
+
+			addColumn(list[i]);
+		}
+
+		if (colListCount[stepCount] == 0)
+			return;
+
+		stepCount++;
+	}
+
+	addFronts(0);
+}
+
+
+/*
+ * Add a new column to the list of possible columns for its generation.
+ */
+static void
+addColumn(RowBits newCol)
+{
+	int	index;
+
+	index = stepCount;
+
+	if (colListCount[index] >= colListMax[index])
+	{
+		colListMax[index] = colListMax[index] * 2 + 64;
+		colList[index] = (RowBits *) realloc(colList[index],
+			colListMax[index] * sizeof(RowBits));
+
+		if (colList[index] == NULL)
+			fatal("Cannot allocate column list");
+	}
+
+	colList[index][colListCount[index]++] = newCol;
+}
+
+
+/*
+ * Add the frontiers for every combination of the possible new columns
+ * of the generations from the specified one onwards.
+ */
+static void
+addFronts(int index)
+{
+	int	gen;
+	int	i;
+
+	if (index >= stepCount)
+	{
+		addFront();
+
+		return;
+	}
+
+	gen = stepGens[index];
+
+	for (i = 0; i < colListCount[index]; i++)
+	{
+		newFront.words[gen * 2] = colList[index][i];
+		addFronts(index + 1);
+	}
+}
+
+
+/*
+ * Add the new frontier, unless it is a duplicate.  An empty frontier
+ * following a non-empty one closes off a spaceship.  Other empty
+ * frontiers are not needed since they just delay the start.
+ */
+static void
+addFront(void)
+{
+	RowBits	any;
+	int	i;
+
+	any = 0;
+
+	for (i = 0; i < frontWords; i++)
+		any |= newFront.words[i];
+
+	if (any == 0)
+	{
+		for (i = 0; i < frontWords; i++)
+			any |= curFront.words[i];
+
+		if (any)
+			closed = TRUE;
+
+		return;
+	}
+
+	if (frontCount - frontBase >= frontLimit)
+		spillFronts();
+
+	if (findFront(&newFront) != NO_FRONT)
+		return;
+
+	frontTable[frontCount - frontBase] = newFront;
+	frontCount++;
+}
+
+
+/*
+ * Check that a column of generation 0 is within the limits for the
+ * number of ON cells in a column and the width of a column.
+ */
+Bool
+columnFits(RowBits col)
+{
+	int	count;
+	int	minRow;
+	int	maxRow;
+	int	row;
+
+	if ((colCells == 0) && (colWidth == 0))
+		return TRUE;
+
+	count = 0;
+	minRow = rowMax + 1;
+	maxRow = 0;
+
+	for (row = 1; row <= rowMax; row++)
+	{
+		if ((col & (1ULL << row)) == 0)
+			continue;
+
+		count++;
+
+		if (row < minRow)
+			minRow = row;
+
+		maxRow = row;
+	}
+
+	if (colCells && (count > colCells))
+		return FALSE;
+
+	if (colWidth && (maxRow - minRow >= colWidth))
+		return FALSE;
+
+	return TRUE;
+}
+
+
+/*
+ * Copy the frontier with the specified index, reading it from the file
+ * if it is no longer in memory.
+ */
+static void
+readFront(long index, Front * front)
+{
+	if (index >= frontBase)
+	{
+		*front = frontTable[index - frontBase];
+
+		return;
+	}
+
+	if ((fseek(spillFile, index * (long) sizeof(Front), SEEK_SET) != 0) ||
+		(fread(front, sizeof(Front), 1, spillFile) != 1))
+	{
+		fatal("Cannot read frontier file");
+	}
+}
+
+
+/*
+ * Look for a frontier in memory with the same columns as the specified
+ * one which is at the same phase of the steps, returning its index.
+ * If there is none, the hash table slot is filled in with the next
+ * frontier index and NO_FRONT is returned.
+ */
+static long
+findFront(const Front * front)
+{
+	unsigned long long	hash;
+	const Front *		old;
+	long			slot;
+	int			phase;
+	int			i;
+
+	phase = front->depth % phases;
+	hash = phase;
+
+	for (i = 0; i < frontWords; i++)
+		hash = (hash ^ front->words[i]) * 0x9e3779b97f4a7c15ULL;
+
+	slot = (long) (hash >> 32) & (hashSize - 1);
+
+	while (hashTable[slot] != NO_FRONT)
+	{
+		old = &frontTable[hashTable[slot] - frontBase];
+
+		if (((old->depth % phases) == phase) &&
+			(memcmp(old->words, front->words,
+				frontWords * sizeof(RowBits)) == 0))
+		{
+			return hashTable[slot];
+		}
+
+		slot = (slot + 1) & (hashSize - 1);
+	}
+
+	hashTable[slot] = frontCount;
+
+	return NO_FRONT;
+}
+
+
+/*
+ * Rebuild the hash table from the frontiers in memory.
+ */
+static void
+hashFronts(void)
+{
+	long	count;
+	long	index;
+
+	for (index = 0; index < hashSize; index++)
+		hashTable[index] = NO_FRONT;
+
+	count = frontCount;
+
+	for (frontCount = frontBase; frontCount < count; frontCount++)
+		findFront(&frontTable[frontCount - frontBase]);
+}
+
+
+/*
+ * Write the older half of the frontiers in memory to the frontier file
+ * to make room for more.  They are still needed for extending and for
+ * showing spaceships, but are no longer checked for duplicates.
+ */
+static void
+spillFronts(void)
+{
+	long	count;
+
+	if (spillFile == NULL)
+	{
+		spillFile = tmpfile();
+
+		if (spillFile == NULL)
+			fatal("Cannot create frontier file");
+	}
+
+	count = (frontCount - frontBase + 1) / 2;
+
+	if ((fseek(spillFile, frontBase * (long) sizeof(Front), SEEK_SET)
+		!= 0) ||
+		(fwrite(frontTable, sizeof(Front), count, spillFile) != count))
+	{
+		fatal("Cannot write frontier file");
+	}
+
+	memmove(frontTable, &frontTable[count],
+		(frontCount - frontBase - count) * sizeof(Front));
+
+	frontBase += count;
+
+	hashFronts();
+}
+
+
+/*
+ * Keep only the frontiers of the next step which have the fewest ON
+ * cells, so that the queue for each step is no longer than the beam
+ * width.  Frontiers which have been written to the file are all kept.
+ */
+static void
+pruneStep(void)
+{
+	long	first;
+	long	keep;
+
+	if (frontCount - frontHead <= frontBeam)
+		return;
+
+	first = (frontHead > frontBase) ? frontHead : frontBase;
+	keep = frontBeam - (first - frontHead);
+
+	if (keep < 1)
+		keep = 1;
+
+	if (frontCount - first <= keep)
+		return;
+
+	qsort(&frontTable[first - frontBase], frontCount - first,
+		sizeof(Front), frontSortFunc);
+
+	frontCount = first + keep;
+
+	hashFronts();
+}
+
+
+/*
+ * Return the number of ON cells in a frontier.
+ */
+static int
+frontCells(const Front * front)
+{
+	RowBits	bits;
+	int	count;
+	int	i;
+
+	count = 0;
+
+	for (i = 0; i < frontWords; i++)
+	{
+		for (bits = front->words[i]; bits; bits &= bits - 1)
+			count++;
+	}
+
+	return count;
+}
+
+
+/*
+ * Compare two frontiers for sorting by their number of ON cells.
+ */
+static int
+frontSortFunc(const void * addr1, const void * addr2)
+{
+	int	count1;
+	int	count2;
+
+	count1 = frontCells((const Front *) addr1);
+	count2 = frontCells((const Front *) addr2);
+
+	return count1 - count2;
+}
+
+
+/*
+ * Set the cells of all generations to the spaceship which ends with
+ * the current frontier, by following its parents back to the start.
+ */
+static void
+showShip(void)
+{
+	Front	front;
+	Cell *	cell;
+	int	row;
+	int	col;
+	int	gen;
+
+	for (gen = 0; gen < genMax; gen++)
+	{
+		for (row = 1; row <= rowMax; row++)
+		{
+			for (col = 1; col <= colMax; col++)
+				findCell(row, col, gen)->state = OFF;
+		}
+	}
+
+	cellCount = 0;
+	front = curFront;
+
+	while (front.depth > 0)
+	{
+		for (gen = 0; gen < genMax; gen++)
+		{
+			if (!stepColumn(front.depth, gen, &col))
+				continue;
+
+			for (row = 1; row <= rowMax; row++)
+			{
+				if ((front.words[gen * 2] & (1ULL << row)) == 0)
+					continue;
+
+				cell = findCell(row, col + colOffset, gen);
+				cell->state = ON;
+
+				if (gen == 0)
+					cellCount++;
+			}
+		}
+
+		readFront(front.parent, &front);
+	}
+}
+
+/* END CODE */
@@ -14,10 +14,32 @@
 static	Bool	noWait;		/* don't wait for commands after loading */
 static	Bool	setAll;		/* set all cells from initial file */
 static	Bool	isLife;		/* whether the rules are for standard Life */
-static	char	ruleString[20];	/* rule string for printouts */
+static	char	ruleString[RULE_SIZE];	/* rule string for printouts */
 static	long	foundCount;	/* number of objects found */
 static	char *	initFile;	/* file containing initial cells */
 static	char *	loadFile;	/* file to load state from */
+static	char *	hintFile;	/* file containing hinted cells */
+
+
+/*
+ * The letters naming the isotropic neighborhoods for each number of
+ * neighbors up to four, and one neighborhood for each letter.  These
+ * have bit 3*R+C set for the cell in row R and column C, and those for
+ * more than four neighbors are the complements of those for fewer.
+ */
+static	const char *	shapeLetters[5] =
+{
+	"", "ce", "ceaikn", "ceaiknjqry", "ceaiknjqrytwz"
+};
+
+static	const int	shapeNeighbors[5][13] =
+{
+	{0},
+	{1, 2},
+	{5, 10, 3, 40, 33, 68},
+	{69, 42, 11, 7, 98, 13, 14, 70, 41, 97},
+	{325, 170, 15, 45, 99, 71, 106, 102, 43, 101, 105, 78, 108}
+};
 
 
 /*
@@ -31,10 +53,20 @@ static	void		getExclude(const char *);
 static	void		getFreeze(const char *);
 static	void		excludeCone(int, int, int);
 static	void		freezeCell(int, int);
+static	void		printActivity(int);
 static	Status		loadState(const char *);
-static	Status		readFile(const char *);
+static	Status		readFile(const char *, Bool);
+static	Status		readFrozen(const char *);
+static	Bool		growArea(void);
 static	Bool		confirm(const char *);
 static	Bool		setRules(const char *);
+static	Bool		parseRules(const char *, State *, State *, State *);
+static	Bool		parseCounts(const char **, State *, int);
+static	int		shapeBits(int, int);
+static	int		neighborCount(int);
+static	void		setShape(State *, int, int);
+static	void		ruleName(char *);
+static	char *		shapeName(char *, int);
 static	long		getNum(const char **, int);
 static	const char *	getStr(const char *, const char *);
 
@@ -55,6 +87,11 @@ static	int *	paramTable[] =
 	&parent, &allObjects, &nearCols, &maxCount,
 	&useRow, &useCol, &colCells, &colWidth, &follow,
 	&orderWide, &orderGens, &orderMiddle, &followGens,
+	&orderDynamic, &orderActivity, &activityBlend,
+	&learnValues, &randomSeed,
+	&restartFreq, &restartGeom, &restartKeep, &phaseCanon,
+	&useEdges, &symAlias, &orderColumns, &useLookup,
+	&wrapRows, &wrapCols, &rowShift, &colShift,
 	NULL
 };
 
@@ -174,6 +211,14 @@ main(int argc, char ** argv)
 						followGens = TRUE;
 						break;
 
+					case 'l':
+						learnValues = TRUE;
+						break;
+
+					case 's':
+						shareFrozen = TRUE;
+						break;
+
 					case '\0':
 						follow = TRUE;
 						break;
@@ -218,6 +263,14 @@ main(int argc, char ** argv)
 						bwdSym = TRUE;
 						break;
 
+					case 'g':
+						phaseCanon = TRUE;
+						break;
+
+					case 'a':
+						symAlias = TRUE;
+						break;
+
 					default:
 						fatal("Bad symmetry");
 				}
@@ -270,6 +323,10 @@ main(int argc, char ** argv)
 						useCol = atoi(str);
 						break;
 
+					case 'e':
+						useEdges = TRUE;
+						break;
+
 					default:
 						fatal("Bad use");
 				}
@@ -331,6 +388,17 @@ main(int argc, char ** argv)
 				argc--;
 				break;
 
+			case 'h':
+				/*
+				 * Read hint file.
+				 */
+				if ((argc <= 0) || (**argv == '-'))
+					fatal("Missing hint file name");
+
+				hintFile = *argv++;
+				argc--;
+				break;
+
 			case 'o':
 				/*
 				 * Set output columns or file name.
@@ -369,6 +437,26 @@ main(int argc, char ** argv)
 							orderMiddle = TRUE;
 							break;
 
+						case 'd':
+							orderDynamic = TRUE;
+							break;
+
+						case 'c':
+							orderColumns = TRUE;
+							break;
+
+						case 'a':
+							orderActivity = TRUE;
+							activityBlend = 0;
+
+							while (isDigit(*str))
+							{
+								activityBlend = activityBlend * 10 +
+									(*str++ - '0');
+							}
+
+							break;
+
 						default:
 							fatal("Bad ordering option");
 					}
@@ -398,9 +486,29 @@ main(int argc, char ** argv)
 
 			case 'p':
 				/*
-				 * Find parents only.
+				 * Find parents only, maybe by sweeping columns,
+				 * or find ancestors a generation at a time.
 				 */
 				parent = TRUE;
+
+				if (*str == 'c')
+					parentCols = TRUE;
+
+				if (*str == 'a')
+				{
+					findAncestors = TRUE;
+					ancestorBreadth = ANCESTOR_BREADTH;
+
+					if (str[1])
+						ancestorBreadth = atoi(str + 1);
+
+					if ((argc > 0) && (**argv != '-'))
+					{
+						argc--;
+						ancestorFile = *argv++;
+					}
+				}
+
 				break;
 
 			case 'a':
@@ -410,6 +518,88 @@ main(int argc, char ** argv)
 				allObjects = TRUE;
 				break;
 
+			case 'b':
+				/*
+				 * Restart the search after backtracking.
+				 */
+				if (*str == 'k')
+				{
+					restartKeep = TRUE;
+					break;
+				}
+
+				if (*str == 'g')
+				{
+					restartGeom = TRUE;
+					str++;
+				}
+
+				restartFreq = RESTART_FREQ;
+
+				if (*str)
+					restartFreq = atoi(str);
+
+				break;
+
+			case 'e':
+				/*
+				 * Extend spaceships by column frontiers.
+				 */
+				if (*str == 'm')
+				{
+					frontMemory = atoi(str + 1);
+					break;
+				}
+
+				frontSearch = TRUE;
+				frontBeam = atoi(str);
+				break;
+
+			case 'x':
+				/*
+				 * Check completed columns against lookups.
+				 */
+				useLookup = TRUE;
+				break;
+
+			case 'T':
+				/*
+				 * Wrap rows or columns around as a torus,
+				 * shifting the other way at the seam.
+				 */
+				switch (*str++)
+				{
+					case 'r':
+						wrapRows = TRUE;
+						rowShift = atoi(str);
+						break;
+
+					case 'c':
+						wrapCols = TRUE;
+						colShift = atoi(str);
+						break;
+
+					default:
+						fatal("Bad torus");
+				}
+
+				break;
+
+			case 'G':
+				/*
+				 * Grow the search area up to the rows and
+				 * columns given.
+				 */
+				growBox = TRUE;
+				break;
+
+			case 'S':
+				/*
+				 * Set seed for random choices.
+				 */
+				randomSeed = atoi(str);
+				break;
+
 			case 'D':
 				/*
 				 * Turn on debugging output.
@@ -445,6 +635,36 @@ main(int argc, char ** argv)
 	if ((pointSym != 0) + (rowSym || colSym) + (fwdSym || bwdSym) > 1)
 		fatal("Conflicting symmetries specified");
 
+	if (phaseCanon &&
+		(rowTrans || colTrans || flipQuads || flipRows || flipCols))
+	{
+		fatal("Cannot specify translations or flips with -sg");
+	}
+
+	if (phaseCanon && (parent || nearCols || colWidth || maxCount ||
+		colCells || useRow || useCol))
+	{
+		fatal("Cannot specify -p or generation 0 limits with -sg");
+	}
+
+	if (useEdges && (parent || useRow || useCol))
+		fatal("Cannot specify -p, -ur, or -uc with -ue");
+
+	if (symAlias &&
+		(rowTrans || colTrans || flipQuads || flipRows || flipCols))
+	{
+		fatal("Cannot specify translations or flips with -sa");
+	}
+
+	if (symAlias && ((rowSym > 1) || (colSym > 1)))
+		fatal("Cannot specify symmetry for only part of the area with -sa");
+
+	if (symAlias && (phaseCanon || useEdges || nearCols || colWidth ||
+		maxCount || colCells || useRow || useCol))
+	{
+		fatal("Cannot specify -sg, -ue, or generation 0 limits with -sa");
+	}
+
 	if ((fwdSym || bwdSym || flipQuads) && (rowMax != colMax))
 		fatal("Rows must equal cols with -sf, -sb, or -fq");
 
@@ -454,12 +674,128 @@ main(int argc, char ** argv)
 	if ((rowTrans && flipRows) || (colTrans && flipCols))
 		fatal("Conflicting translation or flipping specified");
 
+	if (frontSearch && ((colTrans <= 0) || (colTrans >= genMax) ||
+		rowTrans || flipQuads || flipRows || flipCols))
+	{
+		fatal("Must specify only a -tc from 1 to one less than -g with -e");
+	}
+
+	if (frontSearch && (rowSym || colSym || pointSym || fwdSym ||
+		bwdSym || phaseCanon || symAlias || parent || useEdges ||
+		nearCols || maxCount || useRow || useCol))
+	{
+		fatal("Cannot specify symmetry, -p, -ue, -nc, -mt, -ur, or -uc with -e");
+	}
+
+	if (frontSearch && (loadFile || initFile || hintFile || dumpFreq))
+		fatal("Cannot specify -l, -i, -h, or -d with -e");
+
+	if (frontSearch && (ruleTable[0] == ON))
+		fatal("Cannot specify -e for rules with birth on 0 neighbors");
+
+	if ((frontBeam < 0) || (frontMemory < 0))
+		fatal("Bad number for -e");
+
+	if (parentCols && (genMax != 2))
+		fatal("Must specify -g2 with -pc");
+
+	if (findAncestors && (genMax < 2))
+		fatal("Must specify at least -g2 with -pa");
+
+	if ((parentCols || findAncestors) && (rowSym || colSym || pointSym ||
+		fwdSym || bwdSym || symAlias || nearCols || maxCount ||
+		useRow || useCol))
+	{
+		fatal("Cannot specify symmetry, -nc, -mt, -ur, or -uc with -pc or -pa");
+	}
+
+	if ((parentCols || findAncestors) && (loadFile || dumpFreq))
+		fatal("Cannot specify -l or -d with -pc or -pa");
+
+	if ((parentCols || findAncestors) && (ruleTable[0] == ON))
+		fatal("Cannot specify -pc or -pa for rules with birth on 0 neighbors");
+
+	if (ancestorBreadth < 0)
+		fatal("Bad number for -pa");
+
+	if (orderColumns && (rowMax > PATTERN_ROWS))
+		fatal("Too many rows for -oc");
+
+	if (useLookup && symAlias)
+		fatal("Cannot specify -sa with -x");
+
+	if (orderColumns && symAlias)
+		fatal("Cannot specify -sa with -oc");
+
+	if ((rowShift && !wrapCols) || (colShift && !wrapRows))
+		fatal("Must specify both -Tr and -Tc to shift at a seam");
+
+	if (rowShift && colShift)
+		fatal("Cannot shift at both seams of a torus");
+
+	if ((wrapRows || wrapCols) && (useEdges || growBox || useLookup ||
+		shareFrozen || frontSearch || parentCols || findAncestors))
+	{
+		fatal("Cannot specify -ue, -G, -x, -fs, -e, -pc, or -pa with -Tr or -Tc");
+	}
+
+	if (ruleRange && (useLookup || frontSearch || parentCols ||
+		findAncestors))
+	{
+		fatal("Cannot specify -x, -e, -pc, or -pa with a range of rules");
+	}
+
+	if (growBox && (parent || useEdges || useRow || useCol || symAlias))
+		fatal("Cannot specify -p, -ue, -ur, -uc, or -sa with -G");
+
+	if (growBox && (loadFile || initFile || hintFile || dumpFreq ||
+		frontSearch))
+	{
+		fatal("Cannot specify -l, -i, -h, -d, or -e with -G");
+	}
+
+	if (shareFrozen && (initFile == NULL))
+		fatal("Must specify -i with -fs");
+
+	if (shareFrozen && (rowTrans || colTrans || flipRows || flipCols ||
+		flipQuads || rowSym || colSym || pointSym || fwdSym ||
+		bwdSym || symAlias))
+	{
+		fatal("Cannot specify translations, flips, or symmetry with -fs");
+	}
+
+	if (shareFrozen && (phaseCanon || useEdges || parent || useLookup ||
+		loadFile || dumpFreq))
+	{
+		fatal("Cannot specify -sg, -ue, -p, -x, -l, or -d with -fs");
+	}
+
+	if (useLookup && (rowMax > PATTERN_ROWS))
+		fatal("Too many rows for -x");
+
 	if ((useRow < 0) || (useRow > rowMax))
 		fatal("Bad row for -ur");
 
 	if ((useCol < 0) || (useCol > colMax))
 		fatal("Bad column for -uc");
 
+	if ((nearCols < 0) || (nearCols > ROW_MAX))
+		fatal("Bad distance for -nc");
+
+	if (restartFreq < 0)
+		fatal("Bad number of backtracks for -b");
+
+	/*
+	 * When growing the search area, start with the smallest one.
+	 */
+	if (growBox)
+	{
+		boxRows = rowMax;
+		boxCols = colMax;
+		rowMax = 1;
+		colMax = 1;
+	}
+
 	if (!ttyOpen())
 		fatal("Cannot initialize terminal");
 
@@ -479,9 +815,20 @@ main(int argc, char ** argv)
 	{
 		initCells();
 
+		if (shareFrozen)
+		{
+			if (readFrozen(initFile) != OK)
+			{
+				ttyClose();
+				exit(1);
+			}
+
+			shareCells();
+		}
+
 		if (initFile)
 		{
-			if (readFile(initFile) != OK)
+			if (readFile(initFile, FALSE) != OK)
 			{
 				ttyClose();
 				exit(1);
@@ -489,6 +836,15 @@ main(int argc, char ** argv)
 
 			baseSet = nextSet;
 		}
+
+		if (hintFile)
+		{
+			if (readFile(hintFile, TRUE) != OK)
+			{
+				ttyClose();
+				exit(1);
+			}
+		}
 	}
 
 	/*
@@ -506,12 +862,31 @@ main(int argc, char ** argv)
 
 	inited = TRUE;
 
+	/*
+	 * The row or column which must be used may already be empty.
+	 */
+	if ((curStatus == OK) && !usableLines())
+		curStatus = ERROR;
+
+	/*
+	 * Still lifes are found a column at a time when possible.
+	 */
+	stillLife = ((loadFile == NULL) && stillUsable());
+
 	/*
 	 * Initial commands are complete, now look for the object.
 	 */
 	while (TRUE)
 	{
-		if (curStatus == OK)
+		if ((curStatus == OK) && frontSearch)
+			curStatus = frontierSearch();
+		else if ((curStatus == OK) && stillLife)
+			curStatus = stillSearch();
+		else if ((curStatus == OK) && parentCols)
+			curStatus = parentSearch();
+		else if ((curStatus == OK) && findAncestors)
+			curStatus = ancestorSearch();
+		else if (curStatus == OK)
 			curStatus = search();
 
 		if ((curStatus == FOUND) && useRow &&
@@ -527,6 +902,17 @@ main(int argc, char ** argv)
 			continue;
 		}
 
+		/*
+		 * When growing the search area, go on to the next size
+		 * once the current size has been searched.
+		 */
+		if (((curStatus == NOT_EXIST) || (curStatus == ERROR)) &&
+			growBox && growArea())
+		{
+			curStatus = OK;
+			continue;
+		}
+
 		if (dumpFreq)
 		{
 			dumpcount = 0;
@@ -669,6 +1055,13 @@ getCommands(void)
 				dumpState(cp);
 				break;
 
+			case 'a':
+				/*
+				 * Show cell activities for this generation.
+				 */
+				printActivity(curGen);
+				break;
+
 			case 'N':
 				/*
 				 * Find next object.
@@ -829,7 +1222,7 @@ getBackup(const char * cp)
 	{
 		cell = backup();
 
-		if (cell == NULL_CELL)
+		if ((cell == NULL_CELL) && !atChoice())
 		{
 			printGen(curGen);
 			ttyStatus("Backed up over all possibilities\n");
@@ -837,12 +1230,23 @@ getBackup(const char * cp)
 			return;
 		}
 
-		state = 1 - cell->state;
+		/*
+		 * Backing up to a column pattern moves on to its next
+		 * pattern, which counts as one cell.
+		 */
+		state = OFF;
 
-		if (blanksToo || (state == ON))
+		if (cell == NULL_CELL)
 			count--;
+		else
+		{
+			state = 1 - cell->state;
 
-		cell->state = UNK;
+			if (blanksToo || (state == ON))
+				count--;
+
+			cell->state = UNK;
+		}
 
 		if (go(cell, state, FALSE) != OK)
 		{
@@ -1126,6 +1530,7 @@ printGen(int gen)
 	int		count;
 	const Cell *	cell;
 	const char *	msg;
+	char		rules[RULE_SIZE];
 
 	curGen = gen;
 
@@ -1155,12 +1560,26 @@ printGen(int gen)
 	}
 	else
 	{
+		/*
+		 * For a range of rules, this shows the rules which
+		 * the search has not yet decided.
+		 */
+		ruleName(rules);
 		ttyPrintf("%s (rule %s, gen %d, cells %d)",
-			msg, ruleString, gen, count);
+			msg, rules, gen, count);
 	}
 
 	ttyPrintf(" -r%d -c%d -g%d", rowMax, colMax, genMax);
 
+	if (growBox)
+		ttyPrintf(" -G (up to %d by %d)", boxRows, boxCols);
+
+	if (wrapRows)
+		ttyPrintf(rowShift ? " -Tr%d" : " -Tr", rowShift);
+
+	if (wrapCols)
+		ttyPrintf(colShift ? " -Tc%d" : " -Tc", colShift);
+
 	if (rowTrans)
 		ttyPrintf(" -tr%d", rowTrans);
 
@@ -1203,7 +1622,14 @@ printGen(int gen)
 	if (bwdSym)
 		ttyPrintf(" -sb");
 
-	if (orderGens || orderWide || orderMiddle)
+	if (phaseCanon)
+		ttyPrintf(" -sg");
+
+	if (symAlias)
+		ttyPrintf(" -sa");
+
+	if (orderGens || orderWide || orderMiddle || orderDynamic ||
+		orderActivity || orderColumns)
 	{
 		ttyPrintf(" -o");
 
@@ -1215,15 +1641,62 @@ printGen(int gen)
 
 		if (orderMiddle)
 			ttyPrintf("m");
+
+		if (orderDynamic)
+			ttyPrintf("d");
+
+		if (orderColumns)
+			ttyPrintf("c");
+
+		if (orderActivity)
+			ttyPrintf("a");
+
+		if (activityBlend)
+			ttyPrintf("%d", activityBlend);
 	}
 
+	if (frontSearch && frontBeam)
+		ttyPrintf(" -e%d", frontBeam);
+	else if (frontSearch)
+		ttyPrintf(" -e");
+
+	if (frontMemory)
+		ttyPrintf(" -em%d", frontMemory);
+
+	if (useLookup)
+		ttyPrintf(" -x");
+
 	if (follow)
 		ttyPrintf(" -f");
 
 	if (followGens)
 		ttyPrintf(" -fg");
 
-	if (parent)
+	if (learnValues)
+		ttyPrintf(" -fl");
+
+	if (shareFrozen)
+		ttyPrintf(" -fs");
+
+	if (restartFreq)
+	{
+		ttyPrintf(restartGeom ? " -bg%d" : " -b%d", restartFreq);
+
+		if (restartKeep)
+			ttyPrintf(" -bk");
+	}
+
+	if (randomSeed || restartFreq)
+		ttyPrintf(" -S%d", randomSeed);
+
+	if (restartCount)
+		ttyPrintf(" [%ld restarts]", restartCount);
+
+	if (parentCols)
+		ttyPrintf(" -pc");
+	else if (findAncestors)
+		ttyPrintf(" -pa%d", ancestorBreadth);
+	else if (parent)
 		ttyPrintf(" -p");
 
 	if (allObjects)
@@ -1235,6 +1708,9 @@ printGen(int gen)
 	if (useCol)
 		ttyPrintf(" -uc%d", useCol);
 
+	if (useEdges)
+		ttyPrintf(" -ue");
+
 	if (nearCols)
 		ttyPrintf(" -nc%d", nearCols);
 
@@ -1253,6 +1729,9 @@ printGen(int gen)
 	if (dumpFreq)
 		ttyPrintf(" -d%ld %s", dumpFreq / DUMP_MULT, dumpFile);
 
+	if (hintFile)
+		ttyPrintf(" -h %s", hintFile);
+
 	if (outputFile)
 	{
 		if (outputCols)
@@ -1285,7 +1764,7 @@ printGen(int gen)
 				case UNK:
 					msg = "? ";
 
-					if (cell->frozen)
+					if (isFrozen(cell))
 						msg = "+ ";
 
 					if (!cell->choose)
@@ -1310,43 +1789,101 @@ printGen(int gen)
 
 
 /*
- * Write the current generation to the specified file.
- * Empty rows and columns are not written.
- * If no file is specified, it is asked for.
- * Filename of "." means write to stdout.
+ * Print the activity of each cell in the specified generation.
+ * The activities are scaled to single digits, with the most active
+ * cell shown as 9 and inactive cells shown as dots.
  */
-void
-writeGen(const char * file, Bool append)
+static void
+printActivity(int gen)
 {
-	FILE *		fp;
-	const Cell *	cell;
 	int		row;
 	int		col;
-	int		ch;
-	int		minRow;
-	int		maxRow;
-	int		minCol;
-	int		maxCol;
-
-	file = getStr(file, "Write object to file: ");
-
-	if (*file == '\0')
-		return;
-
-	fp = stdout;
+	int		maxActivity;
+	int		activity;
+	const Cell *	cell;
+	char		buf[2];
 
-	if (strcmp(file, "."))
-		fp = fopen(file, append ? "a" : "w");
+	maxActivity = 0;
 
-	if (fp == NULL)
+	for (row = 1; row <= rowMax; row++)
 	{
-		ttyStatus("Cannot create \"%s\"\n", file);
+		for (col = 1; col <= colMax; col++)
+		{
+			cell = findCell(row, col, gen);
 
-		return;
+			if (cell->activity > maxActivity)
+				maxActivity = cell->activity;
+		}
 	}
 
-	/*
-	 * First find the minimum bounds on the object.
+	ttyHome();
+	ttyEEop();
+
+	ttyPrintf("Activity (gen %d, conflicts %ld)\n", gen, conflictCount);
+
+	buf[1] = ' ';
+
+	for (row = 1; row <= rowMax; row++)
+	{
+		for (col = 1; col <= colMax; col++)
+		{
+			activity = findCell(row, col, gen)->activity;
+
+			if (activity <= 0)
+				buf[0] = '.';
+			else
+				buf[0] = '0' + (int) ((activity * 9L) / maxActivity);
+
+			ttyWrite(buf, (colMax < 40) + 1);
+		}
+
+		ttyWrite("\n", 1);
+	}
+
+	ttyHome();
+	ttyFlush();
+}
+
+
+/*
+ * Write the current generation to the specified file.
+ * Empty rows and columns are not written, except in a wrapped direction.
+ * If no file is specified, it is asked for.
+ * Filename of "." means write to stdout.
+ */
+void
+writeGen(const char * file, Bool append)
+{
+	FILE *		fp;
+	const Cell *	cell;
+	int		row;
+	int		col;
+	int		ch;
+	int		minRow;
+	int		maxRow;
+	int		minCol;
+	int		maxCol;
+	char		rules[RULE_SIZE];
+
+	file = getStr(file, "Write object to file: ");
+
+	if (*file == '\0')
+		return;
+
+	fp = stdout;
+
+	if (strcmp(file, "."))
+		fp = fopen(file, append ? "a" : "w");
+
+	if (fp == NULL)
+	{
+		ttyStatus("Cannot create \"%s\"\n", file);
+
+		return;
+	}
+
+	/*
+	 * First find the minimum bounds on the object.
 	 */
 	minRow = rowMax;
 	minCol = colMax;
@@ -1384,9 +1921,34 @@ writeGen(const char * file, Bool append)
 		maxCol = 1;
 	}
 
+	/*
+	 * A wrapped direction is written in full so that the object
+	 * still fits together at the seam.
+	 */
+	if (wrapRows)
+	{
+		minRow = 1;
+		maxRow = rowMax;
+	}
+
+	if (wrapCols)
+	{
+		minCol = 1;
+		maxCol = colMax;
+	}
+
 	if (fp == stdout)
 		fprintf(fp, "#\n");
 
+	/*
+	 * For a range of rules, give the rules which the object works in.
+	 */
+	if (ruleRange)
+	{
+		ruleName(rules);
+		fprintf(fp, "#R %s\n", rules);
+	}
+
 	/*
 	 * Now write out the bounded area.
 	 */
@@ -1443,10 +2005,19 @@ dumpState(const char * file)
 	FILE *		fp;
 	Cell **		set;
 	const Cell *	cell;
+	const Choice *	choice;
+	const State *	rule;
 	int		row;
 	int		col;
 	int		gen;
+	int		which;
+	int		i;
 	int **		param;
+	long		count;
+	long		backtracks;
+	long		limit;
+	unsigned long	order;
+	unsigned long	current;
 
 	file = getStr(file, "Dump state to file: ");
 
@@ -1521,14 +2092,80 @@ dumpState(const char * file)
 	{
 		cell = findCell(row, col, 0);
 
-		if (cell->frozen)
+		if (isFrozen(cell))
 			fprintf(fp, "F %d %d\n", row, col);
 	}
 
+	/*
+	 * Dump out the learned value scores of those cells which have one.
+	 */
+	for (row = 1; row <= rowMax; row++)
+		for (col = 1; col <= colMax; col++)
+			for (gen = 0; gen < genMax; gen++)
+	{
+		cell = findCell(row, col, gen);
+
+		if (cell->valueScore)
+		{
+			fprintf(fp, "L %d %d %d %d\n", row, col, gen,
+				cell->valueScore);
+		}
+	}
+
+	/*
+	 * Dump out the hinted states of those cells which have one.
+	 */
+	for (row = 1; row <= rowMax; row++)
+		for (col = 1; col <= colMax; col++)
+			for (gen = 0; gen < genMax; gen++)
+	{
+		cell = findCell(row, col, gen);
+
+		if (cell->hint != UNK)
+		{
+			fprintf(fp, "H %d %d %d %d\n", row, col, gen,
+				cell->hint);
+		}
+	}
+
+	/*
+	 * Dump out the column pattern choices which are being made.
+	 */
+	for (choice = choiceTable; choice < &choiceTable[choiceCount]; choice++)
+	{
+		fprintf(fp, "C %d %d %d %d\n", (int) (choice->mark - setTable),
+			choice->col, (int) choice->rows, (int) choice->pattern);
+	}
+
+	/*
+	 * Dump out the rules which have been decided in a range of rules.
+	 */
+	for (i = 0; i < ruleSetCount; i++)
+	{
+		rule = ruleSetTable[i].rule;
+		which = (rule >= liveRules) && (rule < &liveRules[9]);
+
+		fprintf(fp, "U %d %d %d %d\n",
+			(int) (ruleSetTable[i].mark - setTable), which,
+			(int) (rule - (which ? liveRules : bornRules)), *rule);
+	}
+
+	/*
+	 * Dump out the restarts and the random states.
+	 */
+	if (restartFreq)
+	{
+		getRestarts(&count, &backtracks, &limit, &order, &current);
+
+		fprintf(fp, "B %ld %ld %ld %lu %lu\n", count, backtracks, limit,
+			order, current);
+	}
+
 	/*
 	 * Finish up with the setting offsets and the final line.
 	 */
-	fprintf(fp, "T %d %d\n", baseSet - setTable, nextSet - setTable);
+	fprintf(fp, "T %d %d\n", (int) (baseSet - setTable),
+		(int) (nextSet - setTable));
 	fprintf(fp, "E\n");
 
 	if (fclose(fp))
@@ -1557,10 +2194,20 @@ loadState(const char * file)
 	int		col;
 	int		gen;
 	int		len;
+	int		which;
+	int		count;
 	State		state;
 	Bool		free;
 	Cell *		cell;
+	Choice *	choice;
+	RuleSet *	ruleSet;
 	int **		param;
+	long		restarts;
+	long		backtracks;
+	long		limit;
+	unsigned long	order;
+	unsigned long	current;
+	char *		end;
 	char		buf[LINE_SIZE];
 
 	file = getStr(file, "Load state from file: ");
@@ -1714,6 +2361,89 @@ loadState(const char * file)
 		fgets(buf, LINE_SIZE, fp);
 	}
 
+	/*
+	 * Handle learned value scores.
+	 */
+	while (buf[0] == 'L')
+	{
+		cp = &buf[1];
+		row = getNum(&cp, 0);
+		col = getNum(&cp, 0);
+		gen = getNum(&cp, 0);
+
+		findCell(row, col, gen)->valueScore = getNum(&cp, 0);
+
+		buf[0] = '\0';
+		fgets(buf, LINE_SIZE, fp);
+	}
+
+	/*
+	 * Handle hinted cells.
+	 */
+	while (buf[0] == 'H')
+	{
+		cp = &buf[1];
+		row = getNum(&cp, 0);
+		col = getNum(&cp, 0);
+		gen = getNum(&cp, 0);
+
+		findCell(row, col, gen)->hint = getNum(&cp, 0);
+
+		buf[0] = '\0';
+		fgets(buf, LINE_SIZE, fp);
+	}
+
+	/*
+	 * Handle column pattern choices.
+	 */
+	while (buf[0] == 'C')
+	{
+		cp = &buf[1];
+		choice = &choiceTable[choiceCount++];
+		choice->mark = &setTable[getNum(&cp, 0)];
+		choice->col = getNum(&cp, 0);
+		choice->rows = getNum(&cp, 0);
+		choice->pattern = getNum(&cp, 0);
+		choice->started = TRUE;
+
+		buf[0] = '\0';
+		fgets(buf, LINE_SIZE, fp);
+	}
+
+	/*
+	 * Handle rules decided in a range of rules.
+	 */
+	while (buf[0] == 'U')
+	{
+		cp = &buf[1];
+		ruleSet = &ruleSetTable[ruleSetCount++];
+		ruleSet->mark = &setTable[getNum(&cp, 0)];
+		which = getNum(&cp, 0);
+		count = getNum(&cp, 0);
+		ruleSet->rule = (which ? liveRules : bornRules) + count;
+		*ruleSet->rule = getNum(&cp, 0);
+
+		buf[0] = '\0';
+		fgets(buf, LINE_SIZE, fp);
+	}
+
+	/*
+	 * Handle the restarts and the random states.
+	 */
+	if (buf[0] == 'B')
+	{
+		restarts = strtol(&buf[1], &end, 10);
+		backtracks = strtol(end, &end, 10);
+		limit = strtol(end, &end, 10);
+		order = strtoul(end, &end, 10);
+		current = strtoul(end, &end, 10);
+
+		setRestarts(restarts, backtracks, limit, order, current);
+
+		buf[0] = '\0';
+		fgets(buf, LINE_SIZE, fp);
+	}
+
 	if (buf[0] != 'T')
 	{
 		ttyStatus("Missing table line in state file\n");
@@ -1754,10 +2484,13 @@ loadState(const char * file)
  * Read a file containing initial settings for either gen 0 or the last gen.
  * If setAll is TRUE, both the ON and the OFF cells will be set.
  * If setDeep is TRUE, then OFF cells will be set deeply (in all generations).
+ * If hint is TRUE, the cells are not set but only hinted, so that the
+ * search tries the given states first.  Then both ON and OFF cells are
+ * hinted, and other characters are ignored.
  * Returns OK on success, ERROR on error.
  */
 static Status
-readFile(const char * file)
+readFile(const char * file, Bool hint)
 {
 	FILE *		fp;
 	const char *	cp;
@@ -1790,6 +2523,9 @@ readFile(const char * file)
 
 	while (fgets(buf, LINE_SIZE, fp))
 	{
+		if (buf[0] == '#')
+			continue;
+
 		row++;
 		cp = buf;
 		col = 0;
@@ -1828,16 +2564,20 @@ readFile(const char * file)
 
 				case 'x':
 				case 'X':
-					excludeCone(row, col, activeGen);
+					if (!hint)
+						excludeCone(row, col, activeGen);
+
 					continue;
 
 				case '+':
-					freezeCell(row, col);
+					if (!hint)
+						freezeCell(row, col);
+
 					continue;
 
 				case '.':
 				case ' ':
-					if (!setAll)
+					if (!setAll && !hint)
 						continue;
 
 					if (setDeep)
@@ -1871,6 +2611,14 @@ readFile(const char * file)
 
 			for (gen = minGen; gen <= maxGen; gen++)
 			{
+				if (hint)
+				{
+					if (gen < genMax)
+						findCell(row, col, gen)->hint = state;
+
+					continue;
+				}
+
 				if (proceed(findCell(row, col, gen),
 					state, FALSE) != OK)
 				{
@@ -1897,6 +2645,101 @@ readFile(const char * file)
 }
 
 
+/*
+ * Set the search area to the next size when it is being grown, and set
+ * up the cells again.  The sizes are tried in order of their rows plus
+ * columns, and then of their rows, so that each size is one row or one
+ * column more than an earlier one.  Only square sizes are tried for the
+ * diagonal symmetries and for flipping quadrants.  Returns FALSE when
+ * the largest size has already been searched.
+ */
+static Bool
+growArea(void)
+{
+	int	sum;
+	int	rows;
+	int	cols;
+
+	sum = rowMax + colMax;
+	rows = rowMax + 1;
+
+	while (sum <= boxRows + boxCols)
+	{
+		cols = sum - rows;
+
+		if ((rows > boxRows) || (cols < 1))
+		{
+			sum++;
+			rows = 1;
+			continue;
+		}
+
+		if ((cols <= boxCols) &&
+			(!(fwdSym || bwdSym || flipQuads) || (rows == cols)))
+		{
+			rowMax = rows;
+			colMax = cols;
+			initCells();
+
+			return TRUE;
+		}
+
+		rows++;
+	}
+
+	return FALSE;
+}
+
+
+/*
+ * Freeze the cells which are marked as frozen in the initial object file,
+ * before any of its cells are set, so that the frozen cells can be
+ * shared between generations.  The other characters of the file are
+ * left for readFile.
+ */
+static Status
+readFrozen(const char * file)
+{
+	FILE *	fp;
+	char *	cp;
+	int	row;
+	int	col;
+	char	buf[LINE_SIZE];
+
+	fp = fopen(file, "r");
+
+	if (fp == NULL)
+	{
+		ttyStatus("Cannot open \"%s\"\n", file);
+
+		return ERROR;
+	}
+
+	row = 0;
+
+	while (fgets(buf, LINE_SIZE, fp))
+	{
+		if (buf[0] == '#')
+			continue;
+
+		row++;
+		col = 0;
+
+		for (cp = buf; *cp && (*cp != '\n'); cp++)
+		{
+			col++;
+
+			if ((*cp == '+') && (row <= rowMax) && (col <= colMax))
+				freezeCell(row, col);
+		}
+	}
+
+	fclose(fp);
+
+	return OK;
+}
+
+
 /*
  * Check a string for being NULL, and if so, ask the user to specify a
  * value for it.  Returned string may be static and thus is overwritten
@@ -1996,21 +2839,129 @@ getNum(const char ** cpp, int defnum)
  * Parse a string and set the Life rules from it.
  * Returns TRUE on success, or FALSE on an error.
  * The rules can be "mmm,nnn",  "mmm/nnn", "Bmmm,Snnn", "Bmmm/Snnn",
- * or a hex number in the Wolfram encoding.
+ * or a hex number in the Wolfram encoding.  The digits of the born and
+ * live values can be followed by letters in Hensel's notation to give
+ * rules which are not totalistic.  Two totalistic rules separated by a
+ * colon give a range of rules, where the rules in the first are always
+ * used, the rules not in the second are never used, and the others are
+ * left for the search to decide.
  */
 static Bool
 setRules(const char * cp)
 {
-	char *		cpTemp;
+	const char *	cpColon;
+	State		maxBorn[9];
+	State		maxLive[9];
+	State		maxTable[512];
 	int		i;
-	unsigned int	bits;
+	int		count;
+	char		buf[LINE_SIZE];
+
+	cpColon = strchr(cp, ':');
+
+	if (cpColon == NULL)
+		cpColon = cp + strlen(cp);
+
+	if (cpColon - cp >= LINE_SIZE)
+		return FALSE;
+
+	memcpy(buf, cp, cpColon - cp);
+	buf[cpColon - cp] = '\0';
+
+	if (!parseRules(buf, bornRules, liveRules, ruleTable))
+		return FALSE;
+
+	/*
+	 * A rule is totalistic if the count of neighbors alone
+	 * always decides the new state.
+	 */
+	nonTotalistic = FALSE;
 
 	for (i = 0; i < 9; i++)
 	{
-		bornRules[i] = OFF;
-		liveRules[i] = OFF;
+		if ((bornRules[i] == UNK) || (liveRules[i] == UNK))
+			nonTotalistic = TRUE;
+	}
+
+	ruleRange = FALSE;
+
+	if (*cpColon == ':')
+	{
+		if (nonTotalistic ||
+			!parseRules(cpColon + 1, maxBorn, maxLive, maxTable))
+		{
+			return FALSE;
+		}
+
+		for (i = 0; i < 9; i++)
+		{
+			if ((maxBorn[i] == UNK) || (maxLive[i] == UNK))
+				return FALSE;
+
+			if (((bornRules[i] == ON) && (maxBorn[i] == OFF)) ||
+				((liveRules[i] == ON) && (maxLive[i] == OFF)))
+			{
+				return FALSE;
+			}
+
+			if ((bornRules[i] == OFF) && (maxBorn[i] == ON))
+			{
+				bornRules[i] = UNK;
+				ruleRange = TRUE;
+			}
+
+			if ((liveRules[i] == OFF) && (maxLive[i] == ON))
+			{
+				liveRules[i] = UNK;
+				ruleRange = TRUE;
+			}
+		}
+
+		/*
+		 * Rebuild the table of new states for each neighborhood,
+		 * which is unknown for the rules left to the search.
+		 * The index has bit 3*C+R set for the cell in column C
+		 * and row R of the neighborhood, so that the center cell
+		 * is bit 4.
+		 */
+		for (i = 0; i < 512; i++)
+		{
+			count = neighborCount(i);
+			ruleTable[i] = (i & 0x10) ?
+				liveRules[count] : bornRules[count];
+		}
 	}
 
+	/*
+	 * Construct the rule string for printouts and see if this
+	 * is the normal Life rule.
+	 */
+	ruleName(ruleString);
+
+	isLife = (strcmp(ruleString, "B3/S23") == 0);
+
+	return TRUE;
+}
+
+
+/*
+ * Parse a string giving a single Life rule into the table of new states
+ * for each neighborhood, and into the born and live rules for each count
+ * of neighbors.  A count whose neighborhoods do not all give the same
+ * new state has an unknown rule.
+ * Returns TRUE on success, or FALSE on an error.
+ */
+static Bool
+parseRules(const char * cp, State * born, State * live, State * table)
+{
+	int		i;
+	int		count;
+	unsigned int	bits;
+	State *		rule;
+
+	for (i = 0; i < 512; i++)
+		table[i] = OFF;
+
 	if (*cp == '\0')
 		return FALSE;
 
@@ -2039,15 +2990,10 @@ setRules(const char * cp)
 		if (i & ~0x3ff)
 			return FALSE;
 
-		for (i = 0; i < 9; i++)
+		for (i = 0; i < 512; i++)
 		{
-			if (bits & 0x01)
-				bornRules[i] = ON;
-
-			if (bits & 0x02)
-				liveRules[i] = ON;
-
-			bits >>= 2;
+			count = neighborCount(i);
+			table[i] = (bits >> (count * 2 + ((i & 0x10) != 0))) & 1;
 		}
 	}
 	else
@@ -2058,8 +3004,8 @@ setRules(const char * cp)
 		if ((*cp == 'b') || (*cp == 'B'))
 			cp++;
 
-		while ((*cp >= '0') && (*cp <= '8'))
-			bornRules[*cp++ - '0'] = ON;
+		if (!parseCounts(&cp, table, 0))
+			return FALSE;
 
 		if ((*cp != ',') && (*cp != '/'))
 			return FALSE;
@@ -2069,41 +3015,296 @@ setRules(const char * cp)
 		if ((*cp == 's') || (*cp == 'S'))
 			cp++;
 
-		while ((*cp >= '0') && (*cp <= '8'))
-			liveRules[*cp++ - '0'] = ON;
-
-		if (*cp)
+		if (!parseCounts(&cp, table, 1) || *cp)
 			return FALSE;
 	}
 
 	/*
-	 * Construct the rule string for printouts and see if this
-	 * is the normal Life rule.
+	 * Find the rule for each count of neighbors.
 	 */
-	cpTemp = ruleString;
+	for (count = 0; count < 9; count++)
+	{
+		born[count] = table[shapeBits(count, 0)];
+		live[count] = table[shapeBits(count, 0) | 0x10];
+	}
+
+	for (i = 0; i < 512; i++)
+	{
+		count = neighborCount(i);
+		rule = (i & 0x10) ? &live[count] : &born[count];
+
+		if (*rule != table[i])
+			*rule = UNK;
+	}
+
+	return TRUE;
+}
+
+
+/*
+ * Parse the digits for the born or live rules, each of which can be
+ * followed by letters naming some of its neighborhoods, or by a minus
+ * sign and letters naming the neighborhoods which are left out.  The
+ * neighborhoods are set ON in the table for the specified center state.
+ * Returns TRUE on success, or FALSE on an error.
+ */
+static Bool
+parseCounts(const char ** cpp, State * table, int center)
+{
+	const char *	cp;
+	const char *	letters;
+	const char *	letter;
+	Bool		invert;
+	int		shapes;
+	int		count;
+	int		mask;
+	int		i;
+
+	cp = *cpp;
+
+	while ((*cp >= '0') && (*cp <= '8'))
+	{
+		count = *cp++ - '0';
+		letters = shapeLetters[(count <= 4) ? count : (8 - count)];
+		shapes = strlen(letters);
+
+		if (shapes == 0)
+			shapes = 1;
+
+		invert = (*cp == '-');
+
+		if (invert)
+			cp++;
+
+		mask = 0;
 
-	*cpTemp++ = 'B';
+		while ((*cp >= 'a') && (*cp <= 'z'))
+		{
+			letter = strchr(letters, *cp++);
+
+			if (letter == NULL)
+				return FALSE;
+
+			mask |= (1 << (letter - letters));
+		}
+
+		if (invert && (mask == 0))
+			return FALSE;
+
+		if (invert || (mask == 0))
+			mask ^= (1 << shapes) - 1;
+
+		for (i = 0; i < shapes; i++)
+		{
+			if (mask & (1 << i))
+				setShape(table, shapeBits(count, i), center);
+		}
+	}
+
+	*cpp = cp;
+
+	return TRUE;
+}
+
+
+/*
+ * Return the neighbors of the neighborhood named by the specified letter
+ * index for the specified count of neighbors, with bit 3*R+C set for the
+ * cell in row R and column C.
+ */
+static int
+shapeBits(int count, int index)
+{
+	if (count <= 4)
+		return shapeNeighbors[count][index];
+
+	return ~shapeNeighbors[8 - count][index] & 0x1ef;
+}
+
+
+/*
+ * Return the number of ON neighbors of the center cell for an index
+ * of the table of new states.
+ */
+static int
+neighborCount(int index)
+{
+	int	count;
+
+	count = 0;
+
+	for (index &= ~0x10; index; index &= index - 1)
+		count++;
+
+	return count;
+}
+
+
+/*
+ * Set ON the entries of the table of new states for the specified
+ * neighbors and center state, in all of their rotations and reflections.
+ */
+static void
+setShape(State * table, int neighbors, int center)
+{
+	int	sym;
+	int	bit;
+	int	row;
+	int	col;
+	int	temp;
+	int	index;
+
+	for (sym = 0; sym < 8; sym++)
+	{
+		index = center << 4;
+
+		for (bit = 0; bit < 9; bit++)
+		{
+			if ((neighbors & (1 << bit)) == 0)
+				continue;
+
+			row = bit / 3 - 1;
+			col = bit % 3 - 1;
+
+			if (sym & 1)
+			{
+				temp = row;
+				row = col;
+				col = temp;
+			}
+
+			if (sym & 2)
+				row = -row;
+
+			if (sym & 4)
+				col = -col;
+
+			index |= (1 << ((row + 1) * 3 + col + 1));
+		}
+
+		table[index] = ON;
+	}
+}
+
+
+/*
+ * Store the name of the current rules into the specified buffer.
+ * For a range of rules, the rules which are always used are followed
+ * by a colon and the rules which can be used, so that after an object
+ * is found this gives exactly the rules which the object works in.
+ */
+static void
+ruleName(char * cp)
+{
+	int	i;
+
+	if (nonTotalistic)
+	{
+		*cp++ = 'B';
+		cp = shapeName(cp, 0);
+		*cp++ = '/';
+		*cp++ = 'S';
+		cp = shapeName(cp, 1);
+		*cp = '\0';
+
+		return;
+	}
+
+	*cp++ = 'B';
 
 	for (i = 0; i < 9; i++)
 	{
 		if (bornRules[i] == ON)
-			*cpTemp++ = '0' + i;
+			*cp++ = '0' + i;
 	}
 
-	*cpTemp++ = '/';
-	*cpTemp++ = 'S';
+	*cp++ = '/';
+	*cp++ = 'S';
 
 	for (i = 0; i < 9; i++)
 	{
 		if (liveRules[i] == ON)
-			*cpTemp++ = '0' + i;
+			*cp++ = '0' + i;
 	}
 
-	*cpTemp = '\0';
+	if (ruleRange)
+	{
+		*cp++ = ':';
+		*cp++ = 'B';
 
-	isLife = (strcmp(ruleString, "B3/S23") == 0);
+		for (i = 0; i < 9; i++)
+		{
+			if (bornRules[i] != OFF)
+				*cp++ = '0' + i;
+		}
 
-	return TRUE;
+		*cp++ = '/';
+		*cp++ = 'S';
+
+		for (i = 0; i < 9; i++)
+		{
+			if (liveRules[i] != OFF)
+				*cp++ = '0' + i;
+		}
+	}
+
+	*cp = '\0';
+}
+
+
+/*
+ * Store Hensel's notation for the born or live rules into the specified
+ * buffer, and return the new end of the buffer.  A count with only some
+ * of its neighborhoods gives the letters of those neighborhoods, or else
+ * a minus sign and the letters of the others when that is shorter.
+ */
+static char *
+shapeName(char * cp, int center)
+{
+	const char *	letters;
+	int		count;
+	int		shapes;
+	int		used;
+	int		i;
+
+	for (count = 0; count < 9; count++)
+	{
+		letters = shapeLetters[(count <= 4) ? count : (8 - count)];
+		shapes = strlen(letters);
+
+		if (shapes == 0)
+			shapes = 1;
+
+		used = 0;
+
+		for (i = 0; i < shapes; i++)
+		{
+			if (ruleTable[shapeBits(count, i) | (center << 4)] == ON)
+				used++;
+		}
+
+		if (used == 0)
+			continue;
+
+		*cp++ = '0' + count;
+
+		if (used == shapes)
+			continue;
+
+		if (used * 2 > shapes)
+			*cp++ = '-';
+
+		for (i = 0; i < shapes; i++)
+		{
+			if ((ruleTable[shapeBits(count, i) | (center << 4)] == ON)
+				== (used * 2 <= shapes))
+			{
+				*cp++ = letters[i];
+			}
+		}
+	}
+
+	return cp;
 }
 
 
@@ -2150,18 +3351,41 @@ usage(void)
 	"   -sp  Enforce symmetry around central point",
 	"   -sf  Enforce symmetry on forward diagonal",
 	"   -sb  Enforce symmetry on backward diagonal",
+	"   -sg  Only find each oscillator in its smallest phase",
+	"   -sa  Keep only one cell of each set of symmetrical cells",
 	"   -nc  Near N cells of live cells in previous columns for generation 0",
 	"   -wc  Maximum width of live cells in each column for generation 0",
 	"   -mt  Maximum total live cells for generation 0",
 	"   -mc  Maximum live cells in any column for generation 0",
 	"   -ur  Force using at least one ON cell in the given row for generation 0",
 	"   -uc  Force using at least one ON cell in the given column for generation 0",
+	"   -ue  Force object to touch the top row and left column in some generation",
 	"   -f   First follow the average location of the previous column's cells",
 	"   -fg  First follow settings of previous or next generation",
+	"   -fl  First try the settings which worked best so far in the search",
+	"   -fs  Share frozen cells surrounded by frozen cells over generations",
+	"   -S   Seed for random choices",
+	"   -b   Restart search after Luby sequence of N backtracks until found",
+	"   -bg  Restart search after geometrically growing N backtracks",
+	"   -bk  Keep learned settings and activities over restarts",
 	"   -ow  Set search order to find wide objects first",
 	"   -og  Set search order to examine all gens in a column before next column",
 	"   -om  Set search order to examine from middle column outwards",
+	"   -od  Set search order to pick the most constrained unknown cell",
+	"   -oa  Set search order to pick the cell in the most conflicts",
+	"        (number blends in the normal order worth that many conflicts)",
+	"   -oc  Choose the pattern of a whole column of generation 0 at once",
+	"   -e   Extend spaceships a column at a time keeping all frontiers",
+	"        (number keeps only that many frontiers for each column)",
+	"   -em  Megabytes of memory for frontiers before using a file",
+	"   -x   Check that each completed column has a possible next column",
+	"   -G   Grow the search area up to the rows and columns given",
+	"   -Tr  Wrap rows around as a torus, shifting N columns at the seam",
+	"   -Tc  Wrap columns around as a torus, shifting N rows at the seam",
 	"   -p   Only look for parents of last generation",
+	"   -pc  Look for parents by sweeping columns of pairs (needs -g2)",
+	"   -pa  Look for ancestors a generation at a time trying N parents each",
+	"        (file name can follow to remember patterns with no ancestors)",
 	"   -a   Find all objects (even those with subPeriods)",
 	"   -v   View object every N thousand searches",
 	"   -d   Dump status to file every N thousand searches",
@@ -2170,8 +3394,11 @@ usage(void)
 	"   -i   Read initial object setting both ON and OFF cells",
 	"   -in  Read initial object from file setting only ON cells",
 	"   -id  Read initial object setting OFF cells deeply (all gens)",
+	"   -h   Read object from file whose cells are tried first",
 	"   -o   Output objects to file (appending) every N columns",
 	"   -R   Use Life rules specified by born,live values",
+	"        (or a range of rules given as min:max, or letters after",
+	"        the digits in Hensel's notation for isotropic rules)",
 	NULL
 	};
 
@@ -15,6 +15,7 @@
 #define	COL_MAX		132	/* maximum columns for search rectangle */
 #define	GEN_MAX		8	/* maximum number of generations */
 #define	TRANS_MAX	4	/* largest translation value allowed */
+#define	PATTERN_ROWS	12	/* maximum rows for choosing column patterns */
 
 
 /*
@@ -35,6 +36,17 @@
 #define	DUMP_MULT	1000		/* dumping frequency multiplier */
 #define	DUMP_FILE	"lifesrc.dmp"	/* default dump file name */
 #define	LINE_SIZE	132		/* size of input lines */
+#define	RULE_SIZE	100		/* size of rule names */
+#define	ACTIVITY_BUMP	1024		/* activity added for each conflict */
+#define	ACTIVITY_DECAY	100		/* conflicts between activity decays */
+#define	VALUE_REFUTE	1		/* value score change for a refutation */
+#define	VALUE_FOUND	16		/* value score change for a found object */
+#define	VALUE_LIMIT	1000000		/* limit of value scores */
+#define	RESTART_FREQ	100		/* default backtracks between restarts */
+#define	FRONT_MEMORY	64		/* default megabytes for frontiers */
+#define	LOOKUP_MEMORY	32		/* megabytes for column lookups */
+#define	LOOKUP_LIMIT	1000		/* most next columns for checking */
+#define	ANCESTOR_BREADTH 1000		/* default parents tried for ancestors */
 
 #define	MAX_CELLS	((COL_MAX + 2) * (ROW_MAX + 2) * GEN_MAX)
 #define	AUX_CELLS	(TRANS_MAX * (COL_MAX + ROW_MAX + 4) * 2)
@@ -94,11 +106,18 @@ typedef	unsigned int	Status;
 #define	nStates	3			/* number of states */
 
 
+/*
+ * Bit mask of rows in a column, with bit N for row N.
+ */
+typedef	unsigned long long	RowBits;
+
+
 /*
  * Information about a row.
  */
 typedef	struct
 {
+	int	setCount;	/* number of cells which are set */
 	int	onCount;	/* number of cells which are set on */
 } RowInfo;
 
@@ -111,6 +130,13 @@ typedef struct
 	int	setCount;	/* number of cells which are set */
 	int	onCount;	/* number of cells which are set on */
 	int	sumPos;		/* sum of row positions for on cells */
+	int	cells;		/* number of cells which can be set */
+	RowBits	onRows;		/* rows which are set on */
+	RowBits	unkRows;	/* rows which are unknown */
+	RowBits	needRows;	/* on rows which need a near on cell */
+	Bool	halves;		/* width is limited in each half separately */
+	int	minRow[2];	/* topmost on row of column or of each half */
+	int	maxRow[2];	/* bottommost on row of column or of each half */
 } ColInfo;
 
 
@@ -123,12 +149,19 @@ struct Cell
 {
 	State		state;		/* current state */
 	PackedBool	free;		/* this cell still has free choice */
-	PackedBool	frozen;		/* this cell is frozen in all gens */
+	PackedBool	frozen;		/* this cell or its loop is frozen in all gens */
 	PackedBool	choose;		/* can choose this cell if unknown */
 	short		gen;		/* generation number of this cell */
 	short		row;		/* row of this cell */
 	short		col;		/* column of this cell */
-	short		near;		/* count of cells this cell is near */
+	int		known;		/* known cells in this cell's light cone */
+	int		rank;		/* position in search order, or -1 */
+	int		heapPos;	/* position in search heap, or 0 */
+	int		activity;	/* recent conflicts involving this cell */
+	int		valueScore;	/* learned preference for ON over OFF */
+	State		hint;		/* state to try first, or UNK */
+	int		tieBreak;	/* random order within a column */
+	int		phaseIndex;	/* position in phase order, or -1 */
 	Cell *		search;		/* cell next to be searched */
 	Cell *		past;		/* cell in past at this location */
 	Cell *		future;		/* cell in future at this location */
@@ -141,6 +174,8 @@ struct Cell
 	Cell *		cd;		/* cell to down */
 	Cell *		cdr;		/* cell to down and right */
 	Cell *		loop;		/* next cell in this same loop */
+	Cell *		equal;		/* parent in set of equal cells, or NULL */
+	int		equalRank;	/* depth bound of set below this cell */
 	RowInfo *	rowInfo;	/* info about this cell's row */
 	ColInfo *	colInfo;	/* info about this cell's column */
 };
@@ -148,6 +183,34 @@ struct Cell
 #define	NULL_CELL	((Cell *) 0)
 
 
+/*
+ * A choice of the pattern of ON cells for the unknown cells in a column
+ * of generation 0, which is made as a single decision of the search.
+ * The patterns are tried with OFF before ON in each row, with the rows
+ * nearest the top changing the most slowly.
+ */
+typedef struct
+{
+	Cell **	mark;		/* setting table position before the pattern */
+	int	col;		/* column the pattern is for */
+	RowBits	rows;		/* unknown rows which the pattern sets */
+	RowBits	pattern;	/* rows which are ON in the current pattern */
+	Bool	started;	/* some pattern has been tried */
+} Choice;
+
+
+/*
+ * A rule which has been decided by the search when searching a range
+ * of rules.  It becomes undecided again when the setting table is backed
+ * up to before its mark.
+ */
+typedef struct
+{
+	Cell **	mark;		/* setting table position when decided */
+	State *	rule;		/* entry of bornRules or liveRules */
+} RuleSet;
+
+
 /*
  * Declare this macro so that by default the variables are defined external.
  * In the main program, this is defined as a null value so as to actually
@@ -192,6 +255,23 @@ EXTERN	Bool	orderWide;	/* ordering tries to find wide objects */
 EXTERN	Bool	orderGens;	/* ordering tries all gens first */
 EXTERN	Bool	orderMiddle;	/* ordering tries middle columns first */
 EXTERN	Bool	followGens;	/* try to follow setting of other gens */
+EXTERN	Bool	orderDynamic;	/* ordering picks most constrained cell */
+EXTERN	Bool	orderActivity;	/* ordering picks most conflicting cell */
+EXTERN	int	activityBlend;	/* conflicts the normal order is worth */
+EXTERN	Bool	learnValues;	/* choose states which worked before */
+EXTERN	int	randomSeed;	/* seed for random choices, or zero */
+EXTERN	int	restartFreq;	/* backtracks between restarts, or zero */
+EXTERN	Bool	restartGeom;	/* restarts grow geometrically */
+EXTERN	Bool	restartKeep;	/* keep learned values over restarts */
+EXTERN	Bool	phaseCanon;	/* generation 0 must be the smallest phase */
+EXTERN	Bool	useEdges;	/* object must touch top and left edges */
+EXTERN	Bool	symAlias;	/* symmetrical cells share one cell */
+EXTERN	Bool	orderColumns;	/* choose patterns of whole columns */
+EXTERN	Bool	useLookup;	/* check completed columns have next columns */
+EXTERN	Bool	wrapRows;	/* rows wrap around as a torus */
+EXTERN	Bool	wrapCols;	/* columns wrap around as a torus */
+EXTERN	int	rowShift;	/* columns shifted when rows wrap around */
+EXTERN	int	colShift;	/* rows shifted when columns wrap around */
 
 
 /*
@@ -205,6 +285,21 @@ EXTERN	Bool	quitOk;		/* ok to quit without confirming */
 EXTERN	Bool	inited;		/* initialization has been done */
 EXTERN	State	bornRules[9];	/* rules for whether a cell is to be born */
 EXTERN	State	liveRules[9];	/* rules for whether a live cell stays alive */
+EXTERN	State	ruleTable[512];	/* new state for each 3 by 3 neighborhood */
+EXTERN	Bool	ruleRange;	/* some rules are left for the search to decide */
+EXTERN	Bool	nonTotalistic;	/* rules depend on where the neighbors are */
+EXTERN	Bool	frontSearch;	/* extend spaceships by column frontiers */
+EXTERN	int	frontBeam;	/* frontiers kept for each column, or zero */
+EXTERN	int	frontMemory;	/* megabytes of memory for frontiers */
+EXTERN	Bool	stillLife;	/* search for still lifes a column at a time */
+EXTERN	Bool	parentCols;	/* find parents by sweeping columns */
+EXTERN	Bool	findAncestors;	/* find ancestors a generation at a time */
+EXTERN	int	ancestorBreadth;	/* parents tried for each pattern */
+EXTERN	char *	ancestorFile;	/* file of patterns with no ancestors */
+EXTERN	Bool	shareFrozen;	/* frozen cells are shared by generations */
+EXTERN	Bool	growBox;	/* grow the search area up to the largest size */
+EXTERN	int	boxRows;	/* largest number of rows when growing */
+EXTERN	int	boxCols;	/* largest number of columns when growing */
 EXTERN	int	curGen;		/* current generation for display */
 EXTERN	int	outputCols;	/* number of columns to save for output */
 EXTERN	int	outputLastCols;	/* last number of columns output */
@@ -213,6 +308,8 @@ EXTERN	long	dumpFreq;	/* how often to perform dumps */
 EXTERN	long	dumpcount;	/* counter for dumps */
 EXTERN	long	viewFreq;	/* how often to view results */
 EXTERN	long	viewCount;	/* counter for viewing */
+EXTERN	long	conflictCount;	/* number of conflicts found */
+EXTERN	long	restartCount;	/* number of restarts done */
 EXTERN	char *	dumpFile;	/* dump file name */
 EXTERN	char *	outputFile;	/* file to output results to */
 
@@ -228,6 +325,10 @@ EXTERN	Cell *	fullSearchList;	/* complete list of cells to search */
 EXTERN	RowInfo	rowInfo[ROW_MAX];	/* information about rows of gen 0 */
 EXTERN	ColInfo	colInfo[COL_MAX];	/* information about columns of gen 0 */
 EXTERN	int	fullColumns;	/* columns in gen 0 which are fully set */
+EXTERN	Choice	choiceTable[COL_MAX];	/* column pattern choices being made */
+EXTERN	int	choiceCount;	/* number of column pattern choices */
+EXTERN	RuleSet	ruleSetTable[18];	/* rules decided by the search */
+EXTERN	int	ruleSetCount;	/* number of rules decided by the search */
 
 
 /*
@@ -235,18 +336,37 @@ EXTERN	int	fullColumns;	/* columns in gen 0 which are fully set */
  */
 extern	void	getCommands(void);
 extern	void	initCells(void);
+extern	void	shareCells(void);
 extern	void	printGen(int);
 extern	void	writeGen(const char *, Bool);
 extern	void	dumpState(const char *);
-extern	void	adjustNear(Cell *, int);
 extern	Status	search(void);
+extern	Status	frontierSearch(void);
+extern	Bool	columnFits(RowBits);
+extern	Bool	stillUsable(void);
+extern	Bool	usableLines(void);
+extern	void	getRestarts(long *, long *, long *, unsigned long *,
+			unsigned long *);
+extern	void	setRestarts(long, long, long, unsigned long, unsigned long);
+extern	Status	stillSearch(void);
+extern	const RowBits *	findColumns(int, const RowBits *, const RowBits *,
+			RowBits, RowBits, int, int *);
+extern	int	ruleIndex(RowBits, RowBits, RowBits, int);
+extern	Status	parentSearch(void);
+extern	Bool	startParents(int, const RowBits *, const RowBits *,
+			const RowBits *, const RowBits *);
+extern	Bool	nextParent(RowBits *);
+extern	void	cellColumns(int, RowBits *, RowBits *);
+extern	Status	ancestorSearch(void);
 extern	Status	proceed(Cell *, State, Bool);
 extern	Status	go(Cell *, State, Bool);
 extern	Status	setCell(Cell *, State, Bool);
 extern	Cell *	findCell(int, int, int);
 extern	Cell *	backup(void);
+extern	Bool	atChoice(void);
 extern	Bool	subPeriods(void);
 extern	void	loopCells(Cell *, Cell *);
+extern	Bool	isFrozen(const Cell *);
 extern	void	fatal(const char *);
 extern	Bool	ttyOpen(void);
 extern	Bool	ttyCheck(void);
@@ -0,0 +1,304 @@
+/*
+ * Life search program - column extension lookup routines.
+ * Given two adjacent columns of cells for some generations, the columns
+ * which can follow them are a fixed function of the rules, since each
+ * cell of the middle column must make the cell of the next generation.
+ * The lists of these next columns are built when they are first needed
+ * and are then remembered, until the memory allowed for them is used up.
+ */
+
+#include "lifesrc.h"
+
+
+#define	LOOKUP_WORDS	(GEN_MAX * 2 + 4)	/* words in a lookup key */
+#define	LOOKUP_HASH	(1L << 20)		/* size of lookup hash table */
+#define	TOO_MANY	(-1)			/* count for too many columns */
+
+
+/*
+ * A remembered list of next columns.  The key holds the number of rows
+ * and of generations, the previous and the middle columns of each
+ * generation, and the bits and mask of the cells which the last
+ * generation makes.
+ * It is followed in the same allocation by the next columns, each of
+ * which is a word for each generation.
+ */
+typedef	struct Lookup	Lookup;
+
+struct Lookup
+{
+	Lookup *	next;		/* next lookup in hash chain */
+	int		count;		/* number of next columns */
+	int		limit;		/* limit if there were too many */
+	RowBits		key[1];		/* columns being extended */
+};
+
+
+static	Lookup **	hashTable;	/* remembered lookups */
+static	long		memoryUsed;	/* bytes used by remembered lookups */
+static	int		keyWords;	/* number of words in key */
+static	RowBits		key[LOOKUP_WORDS];	/* key being looked up */
+static	int		gens;		/* generations in columns */
+static	const RowBits *	leftCols;	/* previous columns */
+static	const RowBits *	middleCols;	/* middle columns */
+static	RowBits		wrapBits;	/* cells made by last generation */
+static	RowBits		wrapMask;	/* which cells of wrapBits are known */
+static	RowBits		newCols[GEN_MAX];	/* next column being built */
+static	RowBits *	colList;	/* next columns being found */
+static	int		colCount;	/* number of next columns found */
+static	int		listMax;	/* allocated number of next columns */
+static	int		colLimit;	/* limit on next columns, or zero */
+
+
+/*
+ * Local procedures
+ */
+static	void	addRow(int);
+static	Bool	checkRow(int);
+static	void	addColumn(void);
+
+
+/*
+ * Return the list of columns which can follow the specified columns
+ * of the specified number of generations.  The cells of the middle
+ * columns must be made by the cells around them in the previous
+ * generation.  For the last generation, the cells which it makes are
+ * given by the wrap bits, but only where the wrap mask has a bit set.
+ * The number of columns in the list is returned through the count
+ * pointer, and each column is a word for each generation.  If a limit
+ * is given and there are more columns than that, NULL is returned.
+ * The list remains valid only until the next call.  Each row is tried
+ * OFF before ON, so an empty column is first whenever it is possible.
+ */
+const RowBits *
+findColumns(int genCount, const RowBits * left, const RowBits * middle,
+	RowBits wrap, RowBits mask, int limit, int * count)
+{
+	Lookup *		lookup;
+	unsigned long long	hash;
+	long			size;
+	int			words;
+	int			i;
+
+	gens = genCount;
+	leftCols = left;
+	middleCols = middle;
+	wrapBits = wrap & mask;
+	wrapMask = mask;
+	colLimit = limit;
+
+	keyWords = 0;
+	key[keyWords++] = rowMax;
+	key[keyWords++] = gens;
+
+	for (i = 0; i < gens; i++)
+	{
+		key[keyWords++] = left[i];
+		key[keyWords++] = middle[i];
+	}
+
+	key[keyWords++] = wrapBits;
+	key[keyWords++] = wrapMask;
+
+	if (hashTable == NULL)
+	{
+		hashTable = (Lookup **) calloc(LOOKUP_HASH, sizeof(Lookup *));
+
+		if (hashTable == NULL)
+			fatal("Cannot allocate lookup table");
+	}
+
+	hash = 0;
+
+	for (i = 0; i < keyWords; i++)
+		hash = (hash ^ key[i]) * 0x9e3779b97f4a7c15ULL;
+
+	hash = (hash >> 32) % LOOKUP_HASH;
+
+	for (lookup = hashTable[hash]; lookup; lookup = lookup->next)
+	{
+		if (memcmp(lookup->key, key, keyWords * sizeof(RowBits)))
+			continue;
+
+		/*
+		 * A list which was too long is only useful if the
+		 * limit is no larger now.
+		 */
+		if ((lookup->count == TOO_MANY) &&
+			((limit == 0) || (limit > lookup->limit)))
+		{
+			break;
+		}
+
+		*count = lookup->count;
+
+		if (lookup->count == TOO_MANY)
+			return NULL;
+
+		return &lookup->key[keyWords];
+	}
+
+	/*
+	 * Find the columns by trying each row in turn.
+	 */
+	colCount = 0;
+	addRow(1);
+
+	/*
+	 * Remember the list if there is room for it.  A list which was
+	 * too long is remembered as just its limit.  A new lookup goes
+	 * first in its chain, so that it is found before an older one
+	 * which was too long for a smaller limit.
+	 */
+	words = keyWords;
+
+	if (colCount > 0)
+		words += colCount * gens;
+
+	size = sizeof(Lookup) + (words - 1) * sizeof(RowBits);
+
+	if (memoryUsed + size <= LOOKUP_MEMORY * 1024L * 1024L)
+	{
+		lookup = (Lookup *) malloc(size);
+
+		if (lookup == NULL)
+			fatal("Cannot allocate lookup");
+
+		lookup->count = colCount;
+		lookup->limit = limit;
+		memcpy(lookup->key, key, keyWords * sizeof(RowBits));
+
+		if (colCount > 0)
+		{
+			memcpy(&lookup->key[keyWords], colList,
+				colCount * gens * sizeof(RowBits));
+		}
+
+		lookup->next = hashTable[hash];
+		hashTable[hash] = lookup;
+		memoryUsed += size;
+	}
+
+	*count = colCount;
+
+	return (colCount == TOO_MANY) ? NULL : colList;
+}
+
+
+/*
+ * Try every setting of the specified row of the next column in all of
+ * the generations, and go on to the next row for those which leave the
+ * previous row consistent.  After the last row, the rows below the
+ * search area are OFF and the next column is complete.
+ */
+static void
+addRow(int row)
+{
+	RowBits	bit;
+	int	value;
+	int	gen;
+
+	if (colCount == TOO_MANY)
+		return;
+
+	if (row > rowMax)
+	{
+		if (checkRow(rowMax) && checkRow(rowMax + 1))
+			addColumn();
+
+		return;
+	}
+
+	bit = (1ULL << row);
+
+	for (value = 0; value < (1 << gens); value++)
+	{
+		for (gen = 0; gen < gens; gen++)
+		{
+			if (value & (1 << gen))
+				newCols[gen] |= bit;
+			else
+				newCols[gen] &= ~bit;
+		}
+
+		if (checkRow(row - 1))
+			addRow(row + 1);
+	}
+
+	for (gen = 0; gen < gens; gen++)
+		newCols[gen] &= ~bit;
+}
+
+
+/*
+ * Check that the cells of the specified row in the middle columns make
+ * the cells of the next generation, given the rows of the next column up
+ * to the next one.
+ */
+static Bool
+checkRow(int row)
+{
+	int	gen;
+	int	last;
+
+	last = gens - 1;
+
+	for (gen = 0; gen < last; gen++)
+	{
+		if (ruleTable[ruleIndex(leftCols[gen], middleCols[gen],
+			newCols[gen], row)] != ((middleCols[gen + 1] >> row) & 1))
+		{
+			return FALSE;
+		}
+	}
+
+	if ((wrapMask & (1ULL << row)) == 0)
+		return TRUE;
+
+	return (ruleTable[ruleIndex(leftCols[last], middleCols[last],
+		newCols[last], row)] == ((wrapBits >> row) & 1));
+}
+
+
+/*
+ * Add the next column which has been built to the list, unless the list
+ * is already as long as the limit.
+ */
+static void
+addColumn(void)
+{
+	if (colLimit && (colCount >= colLimit))
+	{
+		colCount = TOO_MANY;
+
+		return;
+	}
+
+	if (colCount >= listMax)
+	{
+		listMax = listMax * 2 + 64;
+		colList = (RowBits *) realloc(colList,
+			listMax * GEN_MAX * sizeof(RowBits));
+
+		if (colList == NULL)
+			fatal("Cannot allocate column list");
+	}
+
+	memcpy(&colList[colCount * gens], newCols, gens * sizeof(RowBits));
+	colCount++;
+}
+
+
+/*
+ * Return the index into the rule table for the cell in the specified
+ * row of the middle column, given the three columns around it.
+ */
+int
+ruleIndex(RowBits left, RowBits middle, RowBits right, int row)
+{
+	return (int) ((((left << 1) >> row) & 7) |
+		((((middle << 1) >> row) & 7) << 3) |
+		((((right << 1) >> row) & 7) << 6));
+}
+
+/* END CODE */
@@ -0,0 +1,540 @@
+/*
+ * Life search program - parent search routines.
+ * Each column of a generation only depends on the three columns of the
+ * previous generation around it.  So to find the parents of a pattern,
+ * the columns of the previous generation are swept from left to right,
+ * keeping the set of distinct pairs of adjacent columns which can be
+ * reached so far.  Then the pairs which cannot lead to a complete parent
+ * are marked dead from right to left, and parents are found by following
+ * only the live pairs.  If no pair is left, then the pattern has no
+ * parent within the search area.
+ */
+
+#include "lifesrc.h"
+
+
+#define	NO_PAIR		(-1L)		/* index of no pair */
+
+
+/*
+ * A pair of adjacent columns of the parent.
+ */
+typedef	struct
+{
+	RowBits	cols[2];		/* previous and newest column */
+	Bool	alive;			/* pair leads to a complete parent */
+} Pair;
+
+
+/*
+ * The pairs for each column, with the newest column of the pair being
+ * that column.  Column 0 has just the pair of empty columns.
+ */
+static	Pair *	pairTable[COL_MAX + 1];	/* pairs for each column */
+static	long	pairCount[COL_MAX + 1];	/* number of pairs */
+static	long	pairMax[COL_MAX + 1];	/* allocated number of pairs */
+static	long *	hashTable[COL_MAX + 1];	/* indexes of pairs */
+static	long	hashSize[COL_MAX + 1];	/* size of hash tables (power of two) */
+
+
+/*
+ * The cells which are already known, and the parent being followed.
+ */
+static	RowBits		knownBits[COL_MAX + 2];	/* ON cells of parent */
+static	RowBits		knownMask[COL_MAX + 2];	/* known cells of parent */
+static	RowBits		targetBits[COL_MAX + 2];	/* ON cells of pattern */
+static	RowBits		targetMask[COL_MAX + 2];	/* known cells of pattern */
+static	RowBits *	colList[COL_MAX + 1];	/* possible next columns */
+static	int		listCount[COL_MAX + 1];	/* number of next columns */
+static	int		listMax[COL_MAX + 1];	/* allocated size of lists */
+static	int		listIndex[COL_MAX + 1];	/* next column being tried */
+static	long		pairIndex[COL_MAX + 1];	/* pair being followed */
+static	RowBits		allRows;	/* rows of a column including edges */
+static	int		depth;		/* column being extended */
+static	Bool		following;	/* a parent is being followed */
+static	Bool		limitCols;	/* parent is limited by -mc and -wc */
+static	Bool		started;	/* search has been started */
+
+
+/*
+ * Local procedures
+ */
+static	Bool	sweepColumns(void);
+static	void	clearPairs(void);
+static	void	findList(int, const Pair *);
+static	Bool	closeParent(const Pair *);
+static	void	addPair(int, RowBits, RowBits);
+static	long	findPair(int, RowBits, RowBits);
+static	long	hashPair(int, RowBits, RowBits);
+static	void	growHash(int);
+static	void	showParent(const RowBits *);
+
+
+/*
+ * Search for a parent of generation 1 for -pc.
+ * Returns FOUND with the parent set in the cells, or NOT_EXIST when
+ * there are no more parents.  Further calls continue the search.
+ */
+Status
+parentSearch(void)
+{
+	RowBits	bits[COL_MAX + 2];
+	RowBits	mask[COL_MAX + 2];
+	RowBits	known[COL_MAX + 2];
+	RowBits	knownSet[COL_MAX + 2];
+
+	if (!started)
+	{
+		started = TRUE;
+		cellColumns(1, bits, mask);
+		cellColumns(0, known, knownSet);
+
+		if (!startParents(0, bits, mask, known, knownSet))
+			return NOT_EXIST;
+	}
+
+	if (!nextParent(bits))
+		return NOT_EXIST;
+
+	showParent(bits);
+
+	return FOUND;
+}
+
+
+/*
+ * Start finding the parents in the specified generation of a pattern,
+ * whose cells are given by the bits of the columns where the mask is set.
+ * The cells of the parent generation which are already known are given
+ * by the bits of the known columns where the known mask is set, and
+ * these are kept.  The columns of generation 0 are limited as usual.
+ * Returns FALSE if there is no parent.
+ */
+Bool
+startParents(int gen, const RowBits * bits, const RowBits * mask,
+	const RowBits * known, const RowBits * knownSet)
+{
+	int	col;
+
+	for (col = 0; col <= colMax + 1; col++)
+	{
+		knownBits[col] = known[col] & knownSet[col];
+		knownMask[col] = knownSet[col];
+		targetBits[col] = bits[col] & mask[col];
+		targetMask[col] = mask[col];
+	}
+
+	allRows = (1ULL << (rowMax + 2)) - 1;
+	limitCols = (gen == 0);
+	following = FALSE;
+
+	return sweepColumns();
+}
+
+
+/*
+ * Find the next parent by following the live pairs of columns, and
+ * return its columns from column 0 to the one after the last column.
+ * Returns FALSE when there are no more parents.
+ */
+Bool
+nextParent(RowBits * cols)
+{
+	const Pair *	pair;
+	long		child;
+	int		col;
+
+	if (following)
+		listIndex[depth]++;
+	else
+	{
+		if ((pairCount[0] == 0) || !pairTable[0][0].alive)
+			return FALSE;
+
+		following = TRUE;
+		depth = 0;
+		pairIndex[0] = 0;
+		findList(0, &pairTable[0][0]);
+	}
+
+	while (depth >= 0)
+	{
+		if (listIndex[depth] >= listCount[depth])
+		{
+			depth--;
+
+			if (depth >= 0)
+				listIndex[depth]++;
+
+			continue;
+		}
+
+		pair = &pairTable[depth][pairIndex[depth]];
+		child = findPair(depth + 1, pair->cols[1],
+			colList[depth][listIndex[depth]]);
+
+		if ((child == NO_PAIR) || !pairTable[depth + 1][child].alive)
+		{
+			listIndex[depth]++;
+			continue;
+		}
+
+		pairIndex[depth + 1] = child;
+
+		if (ttyCheck())
+			getCommands();
+
+		if (depth + 1 == colMax)
+		{
+			cols[0] = 0;
+			cols[colMax + 1] = 0;
+
+			for (col = 1; col <= colMax; col++)
+			{
+				pair = &pairTable[col][pairIndex[col]];
+				cols[col] = pair->cols[1];
+			}
+
+			return TRUE;
+		}
+
+		depth++;
+		findList(depth, &pairTable[depth][child]);
+	}
+
+	following = FALSE;
+
+	return FALSE;
+}
+
+
+/*
+ * Get the cells of the specified generation as columns, including the
+ * cells around the search area.  The bits are the ON cells and the mask
+ * is the known cells.
+ */
+void
+cellColumns(int gen, RowBits * bits, RowBits * mask)
+{
+	Cell *	cell;
+	int	row;
+	int	col;
+
+	for (col = 0; col <= colMax + 1; col++)
+	{
+		bits[col] = 0;
+		mask[col] = 0;
+
+		for (row = 0; row <= rowMax + 1; row++)
+		{
+			cell = findCell(row, col, gen);
+
+			if (cell->state != UNK)
+				mask[col] |= (1ULL << row);
+
+			if (cell->state == ON)
+				bits[col] |= (1ULL << row);
+		}
+	}
+}
+
+
+/*
+ * Find the pairs of columns which can be reached for every column, and
+ * then mark which of them lead to a complete parent.  Returns FALSE if
+ * there is no parent.
+ */
+static Bool
+sweepColumns(void)
+{
+	Pair *	pair;
+	long	i;
+	int	col;
+	int	j;
+
+	clearPairs();
+	addPair(0, 0, 0);
+
+	for (col = 0; col < colMax; col++)
+	{
+		for (i = 0; i < pairCount[col]; i++)
+		{
+			pair = &pairTable[col][i];
+			findList(col, pair);
+
+			for (j = 0; j < listCount[col]; j++)
+				addPair(col + 1, pair->cols[1], colList[col][j]);
+
+			if (viewFreq && (++viewCount >= viewFreq))
+			{
+				viewCount = 0;
+				ttyStatus("Column %d of %d, %ld pairs\n",
+					col + 1, colMax, pairCount[col + 1]);
+			}
+
+			if (ttyCheck())
+				getCommands();
+		}
+
+		if (pairCount[col + 1] == 0)
+			return FALSE;
+	}
+
+	for (i = 0; i < pairCount[colMax]; i++)
+	{
+		pair = &pairTable[colMax][i];
+		pair->alive = closeParent(pair);
+	}
+
+	for (col = colMax - 1; col >= 0; col--)
+	{
+		for (i = 0; i < pairCount[col]; i++)
+		{
+			pair = &pairTable[col][i];
+			findList(col, pair);
+			pair->alive = FALSE;
+
+			for (j = 0; !pair->alive && (j < listCount[col]); j++)
+			{
+				pair->alive = pairTable[col + 1][findPair(col + 1,
+					pair->cols[1], colList[col][j])].alive;
+			}
+		}
+	}
+
+	return pairTable[0][0].alive;
+}
+
+
+/*
+ * Build the list of the possible columns after the specified pair of
+ * columns, whose newest column is the specified column.  The column of
+ * the pattern there must be made, and the next column must agree with
+ * the known cells.  As usual, cells which were set before the search
+ * started can break the limits for a column, but no more ON cells can
+ * then be added to it.
+ */
+static void
+findList(int col, const Pair * pair)
+{
+	const RowBits *	list;
+	RowBits		next;
+	int		count;
+	int		i;
+
+	list = findColumns(1, &pair->cols[0], &pair->cols[1],
+		targetBits[col], targetMask[col], 0, &count);
+
+	listCount[col] = 0;
+	listIndex[col] = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		next = list[i];
+
+		if ((next ^ knownBits[col + 1]) & knownMask[col + 1])
+			continue;
+
+		if (limitCols && (next & ~knownBits[col + 1]) &&
+			!columnFits(next))
+		{
+			continue;
+		}
+
+		if (listCount[col] >= listMax[col])
+		{
+			listMax[col] = listMax[col] * 2 + 64;
+			colList[col] = (RowBits *) realloc(colList[col],
+				listMax[col] * sizeof(RowBits));
+
+			if (colList[col] == NULL)
+				fatal("Cannot allocate column list");
+		}
+
+		colList[col][listCount[col]++] = next;
+	}
+}
+
+
+/*
+ * Check that a pair of columns ending at the last column makes the last
+ * two columns of the pattern when the columns beyond it are empty.
+ * An empty column is always the first of the possible columns when it
+ * is one of them.
+ */
+static Bool
+closeParent(const Pair * pair)
+{
+	const RowBits *	list;
+	RowBits		empty;
+	int		count;
+
+	empty = 0;
+
+	list = findColumns(1, &pair->cols[0], &pair->cols[1],
+		targetBits[colMax], targetMask[colMax], 0, &count);
+
+	if ((count == 0) || list[0])
+		return FALSE;
+
+	list = findColumns(1, &pair->cols[1], &empty,
+		targetBits[colMax + 1], targetMask[colMax + 1], 0, &count);
+
+	return ((count > 0) && (list[0] == 0));
+}
+
+
+/*
+ * Remove the pairs of columns of all columns, keeping their tables.
+ */
+static void
+clearPairs(void)
+{
+	long	i;
+	int	col;
+
+	for (col = 0; col <= colMax; col++)
+	{
+		pairCount[col] = 0;
+
+		for (i = 0; i < hashSize[col]; i++)
+			hashTable[col][i] = NO_PAIR;
+	}
+}
+
+
+/*
+ * Add a pair of columns for the specified column unless it is already
+ * there.
+ */
+static void
+addPair(int col, RowBits left, RowBits right)
+{
+	Pair *	pair;
+	long	hash;
+
+	if (pairCount[col] * 2 >= hashSize[col])
+		growHash(col);
+
+	hash = hashPair(col, left, right);
+
+	if (hashTable[col][hash] != NO_PAIR)
+		return;
+
+	if (pairCount[col] >= pairMax[col])
+	{
+		pairMax[col] = pairMax[col] * 2 + 256;
+		pairTable[col] = (Pair *) realloc(pairTable[col],
+			pairMax[col] * sizeof(Pair));
+
+		if (pairTable[col] == NULL)
+			fatal("Cannot allocate pairs of columns");
+	}
+
+	pair = &pairTable[col][pairCount[col]];
+	pair->cols[0] = left;
+	pair->cols[1] = right;
+	pair->alive = FALSE;
+	hashTable[col][hash] = pairCount[col]++;
+}
+
+
+/*
+ * Return the index of a pair of columns for the specified column,
+ * or NO_PAIR if it is not there.
+ */
+static long
+findPair(int col, RowBits left, RowBits right)
+{
+	if (hashSize[col] == 0)
+		return NO_PAIR;
+
+	return hashTable[col][hashPair(col, left, right)];
+}
+
+
+/*
+ * Return the position in the hash table of the specified column where
+ * a pair of columns either is or would be put.
+ */
+static long
+hashPair(int col, RowBits left, RowBits right)
+{
+	unsigned long long	hash;
+	const Pair *		pair;
+	long			index;
+
+	hash = (left * 0x9e3779b97f4a7c15ULL) ^ right;
+	hash *= 0xc2b2ae3d27d4eb4fULL;
+	index = (long) (hash >> 32) & (hashSize[col] - 1);
+
+	while (hashTable[col][index] != NO_PAIR)
+	{
+		pair = &pairTable[col][hashTable[col][index]];
+
+		if ((pair->cols[0] == left) && (pair->cols[1] == right))
+			break;
+
+		index = (index + 1) & (hashSize[col] - 1);
+	}
+
+	return index;
+}
+
+
+/*
+ * Double the size of the hash table for the specified column, and put
+ * its pairs back into it.
+ */
+static void
+growHash(int col)
+{
+	const Pair *	pair;
+	long		i;
+
+	hashSize[col] = hashSize[col] ? (hashSize[col] * 2) : 1024;
+	hashTable[col] = (long *) realloc(hashTable[col],
+		hashSize[col] * sizeof(long));
+
+	if (hashTable[col] == NULL)
+		fatal("Cannot allocate pair hash table");
+
+	for (i = 0; i < hashSize[col]; i++)
+		hashTable[col][i] = NO_PAIR;
+
+	for (i = 0; i < pairCount[col]; i++)
+	{
+		pair = &pairTable[col][i];
+		hashTable[col][hashPair(col, pair->cols[0], pair->cols[1])] = i;
+	}
+}
+
+
+/*
+ * Set the cells of both generations from the parent which was found.
+ */
+static void
+showParent(const RowBits * cols)
+{
+	Cell *	cell;
+	int	row;
+	int	col;
+
+	cellCount = 0;
+
+	for (col = 1; col <= colMax; col++)
+	{
+		for (row = 1; row <= rowMax; row++)
+		{
+			cell = findCell(row, col, 0);
+			cell->state = ((cols[col] >> row) & 1) ? ON : OFF;
+			cellCount += (cell->state == ON);
+
+			cell = findCell(row, col, 1);
+			cell->state = ruleTable[ruleIndex(cols[col - 1],
+				cols[col], cols[col + 1], row)];
+		}
+	}
+}
+
+/* END CODE */
@@ -29,6 +29,19 @@ typedef	unsigned char	Flags;
 #define	N1ICUN0	((Flags) 0x40)	/* new cell 1 ==> current unknown neighbors 0 */
 #define	N1ICUN1	((Flags) 0x80)	/* new cell 1 ==> current unknown neighbors 1 */
 
+#define	LONG_BITS	((int) (sizeof(unsigned long) * 8))
+#define	COL_WORDS	(COL_MAX / LONG_BITS + 1)
+
+
+/*
+ * Edges of the search area which the object may have to touch.
+ * The opposite edge of an edge is two more than it.
+ */
+#define	EDGE_TOP	0
+#define	EDGE_LEFT	1
+#define	EDGE_BOTTOM	2
+#define	EDGE_RIGHT	3
+
 
 /*
  * Table of transitions.
@@ -49,6 +62,22 @@ static	State	transit[256];
 static	Flags	implic[256];
 
 
+/*
+ * Tables of transitions and implications for rules which are not
+ * totalistic, indexed by the states of the whole neighborhood of a cell
+ * as a base 3 number, where the digit for the cell in column C and row R
+ * of the neighborhood is 3*C+R places up and is 0 for OFF, 1 for ON,
+ * and 2 for unknown.  For each state of the cell in the next generation,
+ * the implications give the neighborhood cells which are forced ON in
+ * the low bits and those forced OFF from SHAPE_OFF up.
+ */
+#define	SHAPE_COUNT	19683		/* number of neighborhood states */
+#define	SHAPE_OFF	16		/* shift for cells forced OFF */
+
+static	State		shapeTransit[SHAPE_COUNT];
+static	unsigned int	shapeImplic[2][SHAPE_COUNT];
+
+
 /*
  * Table of state values.
  */
@@ -61,12 +90,43 @@ static	State	states[nStates] = {OFF, ON, UNK};
 static	int	newCellCount;		/* cells ready for allocation */
 static	int	auxCellCount;		/* cells in auxillary table */
 static	Cell *	newCells;		/* cells ready for allocation */
+static	Cell *	allCells[MAX_CELLS + AUX_CELLS + 1];	/* cells ever allocated */
+static	int	allCellCount;		/* number of cells ever allocated */
+static	int	usedCellCount;		/* number of those cells in use */
 static	Cell *	deadCell;		/* boundary cell value */
 static	Cell *	searchList;		/* current list of cells to search */
 static	Cell *	cellTable[MAX_CELLS];	/* table of usual cells */
 static	Cell *	auxTable[AUX_CELLS];	/* table of auxillary cells */
+static	Cell *	heap[MAX_CELLS + 1];	/* priority heap of unknown cells */
+static	int	heapCount;		/* number of cells in the heap */
+static	int	searchCount;		/* number of cells in search list */
+static	Bool	useHeap;		/* whether the heap is being used */
+static	unsigned long	randomState;	/* state of random number generator */
+static	unsigned long	orderState;	/* random state for the search order */
+static	long	backtrackCount;		/* backtracks since last restart */
+static	long	restartLimit;		/* backtracks before restart, or zero */
+static	unsigned long	onColumns[COL_WORDS];	/* columns with ON cells */
+static	Cell *	phaseTable[(ROW_MAX + 2) * (COL_MAX + 2)];	/* phase order */
+static	int	phaseCount;		/* number of cells in phase order */
+static	int	phasePos[GEN_MAX];	/* first undecided phase position */
+static	Bool	edgeCheck;		/* object must touch some edges */
+static	Bool	edgeUse[4];		/* edges which object must touch */
+static	Bool	edgeEither[2];		/* touching either opposite edge will do */
+static	int	edgeOn[4];		/* ON cells in each edge of all gens */
+static	int	edgeUnk[4];		/* unknown cells in each edge of all gens */
+static	Bool	periodGen[GEN_MAX];	/* gens which could repeat gen 0 */
+static	Bool	periodTight;		/* some gen may repeat gen 0 */
+static	int	genKnown[GEN_MAX];	/* number of known cells in each gen */
+static	int	genCells[GEN_MAX];	/* number of separate cells in each gen */
+static	Bool	useCounts;		/* limits on ON cells in gen 0 exist */
+static	int	widthStack[ROW_MAX * COL_MAX][4];	/* saved column bounds */
+static	int	widthDepth;		/* number of saved column bounds */
+static	RowBits	nearMask[ROW_MAX + 2];	/* rows within near distance of row */
 static	RowInfo	dummyRowInfo;		/* dummy info for ignored cells */
 static	ColInfo	dummyColInfo;		/* dummy info for ignored cells */
+static	int	colKnown[COL_MAX + 2];	/* known cells in all gens of column */
+static	Cell *	colDone[COL_MAX + 2];	/* cell which completed column */
+static	RowBits	sharedRows[COL_MAX + 2];	/* rows of shared frozen cells */
 
 
 /*
@@ -74,25 +134,76 @@ static	ColInfo	dummyColInfo;		/* dummy info for ignored cells */
  */
 static	void	initTransit(void);
 static	void	initImplic(void);
+static	void	initShapes(void);
 static	void	initSearchOrder(void);
 static	void	linkCell(Cell *);
+static	Cell *	wrapCell(int, int, int);
 static	State	transition(State, int, int);
 static	State	choose(const Cell *);
 static	Flags	implication(State, int, int);
 static	Cell *	symCell(const Cell *);
+static	void	aliasCells(void);
+static	Cell *	sharedCell(Cell *);
+static	void	countGenCells(void);
+static	Cell *	loopFirst(Cell *);
+static	Cell *	equalRoot(Cell *);
 static	Cell *	mapCell(const Cell *, Bool);
 static	Cell *	allocateCell(void);
 static	Cell *	getNormalUnknown(void);
 static	Cell *	getAverageUnknown(void);
+static	Cell *	getDynamicUnknown(void);
 static	Status	consistify(Cell *);
 static	Status	consistify10(Cell *);
+static	Status	consistifyShape(Cell *);
+static	Status	checkRule(Cell *);
+static	void	undoRules(void);
 static	Status	examineNext(void);
 static	Bool	checkWidth(const Cell *);
+static	void	widthParts(const Cell *, int *, int *);
+static	void	adjustWidth(const Cell *);
+static	Status	forceWidth(const Cell *);
+static	Bool	checkNear(const Cell *);
+static	Status	forceNear(const Cell *);
 static	int	getDesc(const Cell *);
 static	int	sumToDesc(State, int);
 static	int	orderSortFunc(const void * addr1, const void * addr2);
 static	Cell *	(*getUnknown)(void);
 static	State	nextState(State, int);
+static	void	initHeap(void);
+static	void	heapInsert(Cell *);
+static	void	heapRemove(Cell *);
+static	void	heapAdjust(Cell *);
+static	Bool	heapBetter(const Cell *, const Cell *);
+static	void	adjustKnown(Cell *, int);
+static	void	bumpKnown(Cell *, int);
+static	int	countKnown(const Cell *);
+static	Status	conflict(Cell *);
+static	void	bumpActivity(Cell *);
+static	void	decayActivity(void);
+static	int	activityKey(const Cell *);
+static	void	learnValue(Cell *, State, int);
+static	void	learnFound(void);
+static	int	randomNumber(void);
+static	void	unsetCell(Cell *);
+static	int	prevOnColumn(int);
+static	void	initPhaseOrder(void);
+static	Status	checkPhase(const Cell *);
+static	Status	checkPhaseGen(int);
+static	Status	checkEdges(void);
+static	Status	forceEdge(int);
+static	void	countEdges(const Cell *, State, int);
+static	Status	checkPeriods(void);
+static	void	adjustPeriods(const Cell *);
+static	Status	checkCounts(const Cell *);
+static	Status	forceLine(int, int, State);
+static	void	restart(void);
+static	void	startPattern(int);
+static	Status	nextPattern(void);
+static	Bool	stepPattern(Choice *, int);
+static	void	backTo(Cell **);
+static	long	getRestartLimit(void);
+static	Status	checkLookup(int);
+static	Status	checkNextColumn(int);
 
 
 /*
@@ -108,6 +219,8 @@ initCells(void)
 	int	gen;
 	int	i;
 	Bool	edge;
+	Bool	rowsFixed;
+	Bool	colsFixed;
 	Cell *	cell;
 	Cell *	cell2;
 
@@ -131,8 +244,12 @@ initCells(void)
 
 	/*
 	 * The first allocation of a cell MUST be deadCell.
-	 * Then allocate the cells in the cell table.
+	 * Then allocate the cells in the cell table.  When the search
+	 * area is set up again for a new size, the cells are reused.
 	 */
+	deadCell = NULL;
+	usedCellCount = 0;
+	auxCellCount = 0;
 	deadCell = allocateCell();
 
 	for (i = 0; i < MAX_CELLS; i++)
@@ -184,12 +301,15 @@ initCells(void)
 				 * If this is not an edge cell, and
 				 * there is some symmetry, then put
 				 * this cell in the same loop as the
-				 * next symmetrical cell.
+				 * next symmetrical cell, if any.
 				 */
 				if ((rowSym || colSym || pointSym ||
 					fwdSym || bwdSym) && !edge)
 				{
-					loopCells(cell, symCell(cell));
+					cell2 = symCell(cell);
+
+					if (cell2 != NULL_CELL)
+						loopCells(cell, cell2);
 				}
 			}
 		}
@@ -206,6 +326,15 @@ initCells(void)
 		{
 			for (col = 0; col <= colMax+1; col++)
 			{
+				/*
+				 * Edge cells which wrap around are not used.
+				 */
+				if ((wrapRows && ((row == 0) || (row > rowMax))) ||
+					(wrapCols && ((col == 0) || (col > colMax))))
+				{
+					continue;
+				}
+
 				cell = findCell(row, col, genMax - 1);
 				cell2 = mapCell(cell, TRUE);
 				cell->future = cell2;
@@ -219,6 +348,34 @@ initCells(void)
 		}
 	}
 
+	/*
+	 * Forget the counts of cells from any earlier search area.
+	 */
+	for (row = 0; row < ROW_MAX; row++)
+	{
+		rowInfo[row].setCount = 0;
+		rowInfo[row].onCount = 0;
+	}
+
+	for (col = 0; col < COL_MAX; col++)
+	{
+		colInfo[col].setCount = 0;
+		colInfo[col].onCount = 0;
+		colInfo[col].sumPos = 0;
+	}
+
+	for (col = 0; col < COL_MAX + 2; col++)
+	{
+		colKnown[col] = 0;
+		colDone[col] = NULL_CELL;
+	}
+
+	for (i = 0; i < COL_WORDS; i++)
+		onColumns[i] = 0;
+
+	fullColumns = 0;
+	cellCount = 0;
+
 	/*
 	 * Initialize the row and column info addresses for generation 0.
 	 */
@@ -232,9 +389,132 @@ initCells(void)
 		}
 	}
 
+	/*
+	 * If wanted, replace the loops of symmetrical cells by single cells.
+	 * Then count the cells of each column which can be set.
+	 */
+	if (symAlias)
+		aliasCells();
+
+	for (col = 1; col <= colMax; col++)
+	{
+		colInfo[col].cells = 0;
+
+		for (row = 1; row <= rowMax; row++)
+		{
+			cell = findCell(row, col, 0);
+
+			if ((cell->row == row) && (cell->col == col))
+				colInfo[col].cells++;
+		}
+	}
+
+	countGenCells();
+
+	widthDepth = 0;
+
+	/*
+	 * Start each column with no ON rows for the width check.
+	 * For symmetric or flipped columns the width is only measured
+	 * from the center to an edge, so each half is bounded separately.
+	 */
+	for (col = 1; col <= colMax; col++)
+	{
+		colInfo[col].halves = ((rowSym && (col >= rowSym)) ||
+			(flipRows && (col >= flipRows)));
+
+		for (i = 0; i < 2; i++)
+		{
+			colInfo[col].minRow[i] = rowMax + 1;
+			colInfo[col].maxRow[i] = 0;
+		}
+	}
+
+	/*
+	 * Set up the masks of the rows within reach of each row for the
+	 * near check, and start with all rows of every column unknown.
+	 */
+	for (row = 1; row <= rowMax; row++)
+	{
+		nearMask[row] = 0;
+
+		for (i = row - nearCols; i <= row + nearCols; i++)
+		{
+			if ((i >= 1) && (i <= rowMax))
+				nearMask[row] |= (1ULL << i);
+		}
+	}
+
+	for (col = 1; col <= colMax; col++)
+	{
+		colInfo[col].onRows = 0;
+		colInfo[col].unkRows = 0;
+		colInfo[col].needRows = 0;
+
+		for (row = 1; row <= rowMax; row++)
+			colInfo[col].unkRows |= (1ULL << row);
+	}
+
+	randomState = randomSeed;
 	initSearchOrder();
 
-	if (follow)
+	if (phaseCanon)
+		initPhaseOrder();
+
+	/*
+	 * When the object has to touch the top and left edges, only do so
+	 * in those directions in which the object could be shifted.  When
+	 * the search area is grown, the object must fill it, and so touch
+	 * both of the opposite edges, or either of them in those directions
+	 * in which the object can only shrink from both sides at once.
+	 */
+	rowsFixed = (rowSym || pointSym || fwdSym || bwdSym || flipRows ||
+		flipQuads);
+	colsFixed = (colSym || pointSym || fwdSym || bwdSym || flipCols ||
+		flipQuads);
+
+	edgeCheck = (useEdges || growBox);
+	edgeUse[EDGE_TOP] = ((useEdges && !rowsFixed) || growBox);
+	edgeUse[EDGE_LEFT] = ((useEdges && !colsFixed) || growBox);
+	edgeUse[EDGE_BOTTOM] = growBox;
+	edgeUse[EDGE_RIGHT] = growBox;
+	edgeEither[EDGE_TOP] = (growBox && rowsFixed);
+	edgeEither[EDGE_LEFT] = (growBox && colsFixed);
+
+	for (i = 0; i < 4; i++)
+	{
+		edgeOn[i] = 0;
+		edgeUnk[i] = (((i == EDGE_TOP) || (i == EDGE_BOTTOM)) ?
+			colMax : rowMax) * genMax;
+	}
+
+	/*
+	 * Unless all objects are wanted, watch for generations whose
+	 * period divides the full period and which could repeat gen 0.
+	 */
+	for (gen = 0; gen < genMax; gen++)
+	{
+		periodGen[gen] = (!allObjects && (genMax > 1) &&
+			((gen == 0) || ((genMax % gen) == 0)));
+		genKnown[gen] = 0;
+	}
+
+	periodTight = FALSE;
+	choiceCount = 0;
+	useCounts = (maxCount || colCells || useRow || useCol);
+
+	useHeap = (orderDynamic || orderActivity);
+	conflictCount = 0;
+	restartCount = 0;
+	backtrackCount = 0;
+	restartLimit = (restartFreq ? getRestartLimit() : 0);
+
+	if (useHeap)
+	{
+		initHeap();
+		getUnknown = getDynamicUnknown;
+	}
+	else if (follow)
 		getUnknown = getAverageUnknown;
 	else
 		getUnknown = getNormalUnknown;
@@ -245,8 +525,19 @@ initCells(void)
 
 	curGen = 0;
 	curStatus = OK;
+
+	/*
+	 * The tables are built from the rules of the whole range, so any
+	 * rules decided by an earlier search are forgotten first.
+	 */
+	while (ruleSetCount > 0)
+		*ruleSetTable[--ruleSetCount].rule = UNK;
+
 	initTransit();
 	initImplic();
+
+	if (nonTotalistic)
+		initShapes();
 }
 
 
@@ -266,6 +557,8 @@ initSearchOrder(void)
 	Cell *	cell;
 	Cell *	table[MAX_CELLS];
 
+	orderState = randomState;
+
 	/*
 	 * Make a table of cells that will be searched.
 	 * Ignore cells that are not relevant to the search due to symmetry.
@@ -282,7 +575,25 @@ initSearchOrder(void)
 		if (colSym && (row >= colSym) && (col * 2 > colMax + 1))
 			continue;
 
-		table[count++] = findCell(row, col, gen);
+		cell = findCell(row, col, gen);
+
+		/*
+		 * Symmetrical or frozen cells which share one cell are
+		 * only searched at the position of that cell.
+		 */
+		if ((cell->row != row) || (cell->col != col) ||
+			(cell->gen != gen))
+		{
+			continue;
+		}
+
+		/*
+		 * When restarting, the cells of each column are shuffled
+		 * randomly in the search order.
+		 */
+		cell->tieBreak = (restartFreq ? randomNumber() : 0);
+
+		table[count++] = cell;
 	}
 
 	/*
@@ -295,11 +606,13 @@ initSearchOrder(void)
 	 * final order.
 	 */
 	searchList = NULL;
+	searchCount = count;
 
 	while (--count >= 0)
 	{
 		cell = table[count];
 		cell->search = searchList;
+		cell->rank = count;
 		searchList = cell;
 	}
 	
@@ -376,6 +689,17 @@ orderSortFunc(const void * addr1, const void * addr2)
 			return 1;
 	}
 
+	/*
+	 * When restarting, shuffle the cells within each column, or within
+	 * each distance from the middle column, so that each restart
+	 * searches a different tree.
+	 */
+	if (c1->tieBreak < c2->tieBreak)
+		return -1;
+
+	if (c1->tieBreak > c2->tieBreak)
+		return 1;
+
 	/*
 	 * Sort "even" positions ahead of "odd" positions.
 	 */
@@ -453,12 +777,6 @@ setCell(Cell * cell, State state, Bool free)
 
 	if (cell->gen == 0)
 	{
-		if (useCol && (colInfo[useCol].onCount == 0)
-			&& (colInfo[useCol].setCount == rowMax) && inited)
-		{
-			return ERROR;
-		}
-
 		if (state == ON)
 		{
 			if (maxCount && (cellCount >= maxCount))
@@ -469,8 +787,8 @@ setCell(Cell * cell, State state, Bool free)
 				return ERROR;
 			}
 
-			if (nearCols && (cell->near <= 0) && (cell->col > 1)
-				&& inited)
+			if (nearCols && (cell->col > 1) && inited &&
+				!checkNear(cell))
 			{
 				return ERROR;
 			}
@@ -484,13 +802,24 @@ setCell(Cell * cell, State state, Bool free)
 			if (colWidth && inited && checkWidth(cell))
 				return ERROR;
 
+			if (colWidth)
+				adjustWidth(cell);
+
 			if (nearCols)
-				adjustNear(cell, 1);
+				cell->colInfo->onRows |= (1ULL << cell->row);
+
+			if (nearCols && (cell->col > 1) && inited)
+				cell->colInfo->needRows |= (1ULL << cell->row);
 
 			cell->rowInfo->onCount++;
-			cell->colInfo->onCount++;
 			cell->colInfo->sumPos += cell->row;
 			cellCount++;
+
+			if (cell->colInfo->onCount++ == 0)
+			{
+				onColumns[cell->col / LONG_BITS] |=
+					(1UL << (cell->col % LONG_BITS));
+			}
 		}
 	}
 
@@ -502,11 +831,33 @@ setCell(Cell * cell, State state, Bool free)
 
 	cell->state = state;
 	cell->free = free;
+	cell->rowInfo->setCount++;
 	cell->colInfo->setCount++;
 
-	if ((cell->gen == 0) && (cell->colInfo->setCount == rowMax))
+	if (nearCols)
+		cell->colInfo->unkRows &= ~(1ULL << cell->row);
+
+	if (cell->heapPos)
+		heapRemove(cell);
+
+	if (orderDynamic)
+		adjustKnown(cell, 1);
+
+	if ((cell->gen == 0) && (cell->colInfo->setCount == cell->colInfo->cells))
 		fullColumns++;
 
+	if (useLookup && (++colKnown[cell->col] == rowMax * genMax))
+		colDone[cell->col] = cell;
+
+	if (periodGen[cell->gen])
+	{
+		genKnown[cell->gen]++;
+		adjustPeriods(cell);
+	}
+
+	if (edgeCheck)
+		countEdges(cell, state, 1);
+
 	return OK;
 }
 
@@ -559,6 +910,9 @@ consistify(Cell * cell)
 	if (parent && (cell->gen == 0))
 		return OK;
 
+	if (nonTotalistic)
+		return consistifyShape(cell);
+
 	/*
 	 * First check the transit table entry for the previous
 	 * generation.  Make sure that this cell matches the ON or
@@ -576,6 +930,9 @@ consistify(Cell * cell)
 			return ERROR;
 	}
 
+	if (ruleRange && (state == UNK) && (checkRule(cell) != OK))
+		return ERROR;
+
 	/*
 	 * Now look up the previous generation in the implic table.
 	 * If this cell implies anything about the cell or its neighbors
@@ -695,6 +1052,137 @@ consistify(Cell * cell)
 }
 
 
+/*
+ * Consistify a cell for rules which are not totalistic.  The whole
+ * neighborhood of the cell in the previous generation is looked up,
+ * which gives the state of the cell if it is decided, and once the
+ * cell is known, which of the unknown cells of the neighborhood are
+ * forced to make it.  Returns ERROR if the cell is inconsistent.
+ */
+static Status
+consistifyShape(Cell * cell)
+{
+	Cell *		prevCell;
+	Cell *		cells[9];
+	State		state;
+	unsigned int	flags;
+	int		index;
+	int		i;
+
+	prevCell = cell->past;
+
+	cells[0] = prevCell->cul;
+	cells[1] = prevCell->cl;
+	cells[2] = prevCell->cdl;
+	cells[3] = prevCell->cu;
+	cells[4] = prevCell;
+	cells[5] = prevCell->cd;
+	cells[6] = prevCell->cur;
+	cells[7] = prevCell->cr;
+	cells[8] = prevCell->cdr;
+
+	index = 0;
+
+	for (i = 8; i >= 0; i--)
+	{
+		state = cells[i]->state;
+		index = index * 3 + (state & ON) + (state / UNK) * 2;
+	}
+
+	state = shapeTransit[index];
+
+	if ((state != UNK) && (setCell(cell, state, FALSE) != OK))
+		return ERROR;
+
+	if (cell->state == UNK)
+		return OK;
+
+	flags = shapeImplic[cell->state][index];
+
+	if (flags == 0)
+		return OK;
+
+	DPRINTF1("Neighborhood implication flags %x\n", flags);
+
+	for (i = 0; i < 9; i++)
+	{
+		if ((flags & (1 << i)) &&
+			(setCell(cells[i], ON, FALSE) != OK))
+		{
+			return ERROR;
+		}
+
+		if ((flags & (1 << (i + SHAPE_OFF))) &&
+			(setCell(cells[i], OFF, FALSE) != OK))
+		{
+			return ERROR;
+		}
+	}
+
+	return OK;
+}
+
+
+/*
+ * Check a cell against the rule used by its neighborhood in the previous
+ * generation when searching a range of rules.  The tables only know the
+ * rules which are the same over the whole range, so once the neighborhood
+ * is completely known, the rule for it here and the state of the cell
+ * must agree, and whichever of them is known decides the other.
+ * A rule which is decided is remembered so that backing up can undo it.
+ */
+static Status
+checkRule(Cell * cell)
+{
+	const Cell *	prevCell;
+	State *		rule;
+	int		sum;
+
+	prevCell = cell->past;
+
+	sum = prevCell->cul->state + prevCell->cu->state + prevCell->cur->state;
+	sum += prevCell->cdl->state + prevCell->cd->state + prevCell->cdr->state;
+	sum += prevCell->cl->state + prevCell->cr->state;
+
+	if ((sum >= UNK) || (prevCell->state == UNK))
+		return OK;
+
+	rule = (prevCell->state == ON) ? &liveRules[sum] : &bornRules[sum];
+
+	if (*rule != UNK)
+		return setCell(cell, *rule, FALSE);
+
+	if (cell->state == UNK)
+		return OK;
+
+	DPRINTF3("Deciding rule %c%d to be %s\n",
+		((prevCell->state == ON) ? 'S' : 'B'), sum,
+		((cell->state == ON) ? "on" : "off"));
+
+	ruleSetTable[ruleSetCount].mark = newSet;
+	ruleSetTable[ruleSetCount].rule = rule;
+	ruleSetCount++;
+	*rule = cell->state;
+
+	return OK;
+}
+
+
+/*
+ * Make undecided again those rules which were decided after the current
+ * end of the setting table.
+ */
+static void
+undoRules(void)
+{
+	while ((ruleSetCount > 0) &&
+		(ruleSetTable[ruleSetCount - 1].mark > newSet))
+	{
+		*ruleSetTable[--ruleSetCount].rule = UNK;
+	}
+}
+
+
 /*
  * See if a cell and its neighbors are consistent with the cell and its
  * neighbors in the next generation.
@@ -703,373 +1191,1542 @@ static Status
 consistify10(Cell * cell)
 {
 	if (consistify(cell) != OK)
-		return ERROR;
+		return conflict(cell);
 
 	if (consistify(cell->future) != OK)
-		return ERROR;
+		return conflict(cell->future);
 
 	if (consistify(cell->cul->future) != OK)
-		return ERROR;
+		return conflict(cell->cul->future);
 
 	if (consistify(cell->cu->future) != OK)
-		return ERROR;
+		return conflict(cell->cu->future);
 
 	if (consistify(cell->cur->future) != OK)
-		return ERROR;
+		return conflict(cell->cur->future);
 
 	if (consistify(cell->cl->future) != OK)
-		return ERROR;
+		return conflict(cell->cl->future);
 
 	if (consistify(cell->cr->future) != OK)
-		return ERROR;
+		return conflict(cell->cr->future);
 
 	if (consistify(cell->cdl->future) != OK)
-		return ERROR;
+		return conflict(cell->cdl->future);
 
 	if (consistify(cell->cd->future) != OK)
-		return ERROR;
+		return conflict(cell->cd->future);
 
 	if (consistify(cell->cdr->future) != OK)
-		return ERROR;
+		return conflict(cell->cdr->future);
 
 	return OK;
 }
 
 
 /*
- * Examine the next choice of cell settings.
+ * Record a failure to consistify the specified cell and return ERROR.
+ * When ordering by activity, every cell which took part in the failure
+ * has its activity increased, and occasionally all activities are decayed
+ * so that recent conflicts count the most.
  */
 static Status
-examineNext(void)
+conflict(Cell * cell)
 {
-	Cell *	cell;
-
-	/*
-	 * If there are no more cells to examine, then what we have
-	 * is consistent.
-	 */
-	if (nextSet == newSet)
-		return CONSISTENT;
-
-	/*
-	 * Get the next cell to examine, and check it out for symmetry
-	 * and for consistency with its previous and next generations.
-	 */
-	cell = *nextSet++;
+	Cell *	prevCell;
 
-	DPRINTF4("Examining saved cell %d %d %d (%s) for consistency\n",
-		cell->row, cell->col, cell->gen,
-		(cell->free ? "free" : "forced"));
+	conflictCount++;
 
-	if (cell->loop && (setCell(cell->loop, cell->state, FALSE) != OK))
-	{
+	if (!orderActivity)
 		return ERROR;
-	}
 
-	return consistify10(cell);
+	prevCell = cell->past;
+
+	bumpActivity(cell);
+	bumpActivity(prevCell);
+	bumpActivity(prevCell->cul);
+	bumpActivity(prevCell->cu);
+	bumpActivity(prevCell->cur);
+	bumpActivity(prevCell->cl);
+	bumpActivity(prevCell->cr);
+	bumpActivity(prevCell->cdl);
+	bumpActivity(prevCell->cd);
+	bumpActivity(prevCell->cdr);
+
+	if ((conflictCount % ACTIVITY_DECAY) == 0)
+		decayActivity();
+
+	return ERROR;
 }
 
 
 /*
- * Set a cell to the specified value and determine all consequences we
- * can from the choice.  Consequences are a contradiction or a consistency.
+ * Set up the order of the cells used for comparing phases.
+ * These are the cells of generation 0 in the search order, so that
+ * the comparison is decided as early in the search as possible.
+ * The cells at the same positions in other generations get the same index.
  */
-Status
-proceed(Cell * cell, State state, Bool free)
+static void
+initPhaseOrder(void)
 {
-	int	status;
+	Cell *	cell;
+	int	gen;
 
-	if (setCell(cell, state, free) != OK)
-		return ERROR;
+	phaseCount = 0;
 
-	for (;;)
+	for (cell = fullSearchList; cell; cell = cell->search)
 	{
-		status = examineNext();
+		if (cell->gen != 0)
+			continue;
 
-		if (status == ERROR)
-			return ERROR;
+		for (gen = 0; gen < genMax; gen++)
+			findCell(cell->row, cell->col, gen)->phaseIndex = phaseCount;
 
-		if (status == CONSISTENT)
-			return OK;
+		phaseTable[phaseCount++] = cell;
 	}
+
+	for (gen = 0; gen < genMax; gen++)
+		phasePos[gen] = 0;
 }
 
 
 /*
- * Back up the list of set cells to undo choices.
- * Returns the cell which is to be tried for the other possibility.
- * Returns NULL_CELL on an "object cannot exist" error.
+ * Check that generation 0 is still the smallest phase of the object
+ * after the specified cell was set.  Phases are compared as strings of
+ * cells in the phase order, with OFF less than ON.  Returns ERROR if
+ * some other generation is known to be smaller than generation 0.
  */
-Cell *
-backup(void)
+static Status
+checkPhase(const Cell * cell)
 {
-	Cell *	cell;
-
-	searchList = fullSearchList;
+	int	gen;
 
-	while (newSet != baseSet)
+	if (cell->gen != 0)
 	{
-		cell = *--newSet;
+		if (cell->phaseIndex != phasePos[cell->gen])
+			return OK;
 
-		DPRINTF5("backing up cell %d %d %d, was %s, %s\n",
-			cell->row, cell->col, cell->gen,
-			((cell->state == ON) ? "on" : "off"),
-			(cell->free ? "free": "forced"));
-
-		if ((cell->state == ON) && (cell->gen == 0))
-		{
-			cell->rowInfo->onCount--;
-			cell->colInfo->onCount--;
-			cell->colInfo->sumPos -= cell->row;
-			cellCount--;
-			adjustNear(cell, -1);
-		}
-
-		if ((cell->gen == 0) && (cell->colInfo->setCount == rowMax))
-			fullColumns--;
-
-		cell->colInfo->setCount--;
+		return checkPhaseGen(cell->gen);
+	}
 
-		if (!cell->free)
+	for (gen = 1; gen < genMax; gen++)
+	{
+		if ((cell->phaseIndex == phasePos[gen]) &&
+			(checkPhaseGen(gen) != OK))
 		{
-			cell->state = UNK;
-			cell->free = TRUE;
-
-			continue;
+			return ERROR;
 		}
-
-		nextSet = newSet;
-
-		return cell;
 	}
 
-	nextSet = baseSet;
-	return NULL_CELL;
+	return OK;
 }
 
 
 /*
- * Do checking based on setting the specified cell.
- * Returns ERROR if an inconsistency was found.
+ * Compare generation 0 with the specified generation.  The position of
+ * the first cell where they are not known to be equal is advanced, and
+ * if only one of the two cells there is known, then the other one may be
+ * forced so that generation 0 does not become the larger phase.
  */
-Status
-go(Cell * cell, State state, Bool free)
+static Status
+checkPhaseGen(int gen)
 {
-	Status	status;
+	Cell *	cell;
+	Cell *	genCell;
+	int	pos;
 
-	quitOk = FALSE;
+	pos = phasePos[gen];
 
-	for (;;)
+	for (; pos < phaseCount; pos++)
 	{
-		status = proceed(cell, state, free);
+		cell = phaseTable[pos];
+		genCell = findCell(cell->row, cell->col, gen);
 
-		if (status == OK)
-			return OK;
+		if ((cell->state == UNK) || (cell->state != genCell->state))
+			break;
+	}
 
-		cell = backup();
+	phasePos[gen] = pos;
 
-		if (cell == NULL_CELL)
+	if (pos >= phaseCount)
+		return OK;
+
+	if (cell->state == ON)
+	{
+		if (genCell->state == OFF)
 			return ERROR;
 
-		free = FALSE;
-		state = 1 - cell->state;
-		cell->state = UNK;
+		return setCell(genCell, ON, FALSE);
 	}
+
+	if ((cell->state == UNK) && (genCell->state == OFF))
+		return setCell(cell, OFF, FALSE);
+
+	return OK;
 }
 
 
 /*
- * Find another unknown cell in a normal search.
- * Returns NULL_CELL if there are no more unknown cells.
+ * Check that the object can still touch the top row and left column
+ * in some generation.  If only one cell is left which can do so, then
+ * it is forced ON.  Returns ERROR if the edge can no longer be touched.
  */
-static Cell *
-getNormalUnknown(void)
+static Status
+checkEdges(void)
 {
-	Cell *	cell;
+	int	edge;
 
-	for (cell = searchList; cell; cell = cell->search)
+	for (edge = EDGE_TOP; edge <= EDGE_LEFT; edge++)
 	{
-		if (!cell->choose)
+		if (!edgeEither[edge])
+		{
+			if ((forceEdge(edge) != OK) ||
+				(forceEdge(edge + 2) != OK))
+			{
+				return ERROR;
+			}
+
 			continue;
+		}
 
-		if (cell->state == UNK)
+		if (edgeUse[edge] && (edgeOn[edge] == 0) &&
+			(edgeUnk[edge] == 0) && (edgeOn[edge + 2] == 0) &&
+			(edgeUnk[edge + 2] == 0))
 		{
-			searchList = cell;
-
-			return cell;
+			return ERROR;
 		}
 	}
 
-	return NULL_CELL;
+	return OK;
 }
 
 
 /*
- * Find another unknown cell when averaging is done.
- * Returns NULL_CELL if there are no more unknown cells.
+ * Check an edge which the object must touch.  If it has no ON cells,
+ * then it must still have an unknown cell, and when it has just one
+ * unknown cell, that cell is forced ON.
  */
-static Cell *
-getAverageUnknown(void)
+static Status
+forceEdge(int edge)
 {
 	Cell *	cell;
-	Cell *	bestCell;
-	int	bestDist;
-	int	curDist;
-	int	wantRow;
-	int	curCol;
-	int	testCol;
+	int	i;
+	int	gen;
 
-	bestCell = NULL_CELL;
-	bestDist = -1;
+	if (!edgeUse[edge] || (edgeOn[edge] > 0))
+		return OK;
 
-	cell = searchList;
+	if (edgeUnk[edge] == 0)
+		return ERROR;
 
-	while (cell)
+	if (edgeUnk[edge] > 1)
+		return OK;
+
+	for (i = 1; i <= (((edge == EDGE_TOP) || (edge == EDGE_BOTTOM)) ?
+		colMax : rowMax); i++)
 	{
-		searchList = cell;
-		curCol = cell->col;
+		for (gen = 0; gen < genMax; gen++)
+		{
+			switch (edge)
+			{
+				case EDGE_TOP:
+					cell = findCell(1, i, gen);
+					break;
 
-		testCol = curCol - 1;
+				case EDGE_BOTTOM:
+					cell = findCell(rowMax, i, gen);
+					break;
 
-		while ((testCol > 0) && (colInfo[testCol].onCount <= 0))
-			testCol--;
+				case EDGE_LEFT:
+					cell = findCell(i, 1, gen);
+					break;
 
-		if (testCol > 0)
-		{
-			wantRow = colInfo[testCol].sumPos /
-				colInfo[testCol].onCount;
+				default:
+					cell = findCell(i, colMax, gen);
+					break;
+			}
+
+			if (cell->state == UNK)
+				return setCell(cell, ON, FALSE);
 		}
-		else
-			wantRow = (rowMax + 1) / 2;
+	}
 
-		for (; cell && (cell->col == curCol); cell = cell->search)
-		{
-			if (!cell->choose)
-				continue;
+	return OK;
+}
 
-			if (cell->state == UNK)
-			{
-				curDist = cell->row - wantRow;
 
-				if (curDist < 0)
-					curDist = -curDist;
+/*
+ * Count a cell which has been set or is being unset in the edges which
+ * it is in.  The delta is 1 for setting the cell and -1 for unsetting it.
+ */
+static void
+countEdges(const Cell * cell, State state, int delta)
+{
+	int	on;
 
-				if (curDist > bestDist)
-				{
-					bestCell = cell;
-					bestDist = curDist;
-				}
-			}
+	on = ((state == ON) ? delta : 0);
+
+	if (cell->row == 1)
+	{
+		edgeUnk[EDGE_TOP] -= delta;
+		edgeOn[EDGE_TOP] += on;
+	}
+
+	if (cell->row == rowMax)
+	{
+		edgeUnk[EDGE_BOTTOM] -= delta;
+		edgeOn[EDGE_BOTTOM] += on;
+	}
+
+	if (cell->col == 1)
+	{
+		edgeUnk[EDGE_LEFT] -= delta;
+		edgeOn[EDGE_LEFT] += on;
+	}
+
+	if (cell->col == colMax)
+	{
+		edgeUnk[EDGE_RIGHT] -= delta;
+		edgeOn[EDGE_RIGHT] += on;
+	}
+}
+
+
+/*
+ * Note whether generation 0 and some generation which could repeat it
+ * have both become completely known after the specified cell was set.
+ * Only then is it worth comparing them.
+ */
+static void
+adjustPeriods(const Cell * cell)
+{
+	int	gen;
+
+	if (cell->gen != 0)
+	{
+		if ((genKnown[0] == genCells[0]) &&
+			(genKnown[cell->gen] == genCells[cell->gen]))
+		{
+			periodTight = TRUE;
 		}
 
-		if (bestCell)
-			return bestCell;
+		return;
 	}
 
-	return NULL_CELL;
+	if (genKnown[0] != genCells[0])
+		return;
+
+	for (gen = 1; gen < genMax; gen++)
+	{
+		if (periodGen[gen] && (genKnown[gen] == genCells[gen]))
+			periodTight = TRUE;
+	}
 }
 
 
 /*
- * Choose a state for an unknown cell, either OFF or ON.
- * Normally, we try to choose OFF cells first to terminate an object.
- * But for follow generations mode, we try to choose the same setting
- * as a nearby generation.
+ * Check each generation which could repeat generation 0 and which is
+ * completely known along with generation 0.  If the two are the same,
+ * then the object has a smaller period whatever the other generations
+ * turn out to be, so this returns ERROR.
  */
-static State
-choose(const Cell * cell)
+static Status
+checkPeriods(void)
 {
-	/*
-	 * If we are following cells in other generations,
-	 * then try to do that.
-	 */
-	if (followGens)
+	const Cell *	cellG0;
+	const Cell *	cellGn;
+	int		row;
+	int		col;
+	int		gen;
+
+	periodTight = FALSE;
+
+	for (gen = 1; gen < genMax; gen++)
 	{
-		if ((cell->past->state == ON) ||
-			(cell->future->state == ON))
+		if (!periodGen[gen] || (genKnown[0] != genCells[0]) ||
+			(genKnown[gen] != genCells[gen]))
 		{
-			return ON;
+			continue;
 		}
 
-		if ((cell->past->state == OFF) ||
-			(cell->future->state == OFF))
+		for (row = 1; row <= rowMax; row++)
+			for (col = 1; col <= colMax; col++)
 		{
-			return OFF;
+			cellG0 = findCell(row, col, 0);
+			cellGn = findCell(row, col, gen);
+
+			if (cellG0->state != cellGn->state)
+				goto nextGen;
 		}
+
+		return ERROR;
+nextGen:;
 	}
 
-	return OFF;
+	return OK;
 }
 
 
 /*
- * The top level search routine.
- * Returns if an object is found, or is impossible.
+ * Check the limits on the ON cells of generation 0 after the specified
+ * cell of that generation was set.  When a limit on the number of ON
+ * cells has been reached, the unknown cells it covers are forced OFF.
+ * When the row or column which must be used has no ON cells and only
+ * one unknown cell, that cell is forced ON.  Returns ERROR if the row
+ * or column can no longer be used.
  */
-Status
-search(void)
+static Status
+checkCounts(const Cell * cell)
 {
-	Cell *	cell;
-	Bool	free;
-	Bool	needWrite;
-	State	state;
-
-	cell = (*getUnknown)();
+	int	unknown;
 
-	if (cell == NULL_CELL)
+	if (cell->state == ON)
 	{
-		cell = backup();
+		if (maxCount && (cellCount >= maxCount) &&
+			(forceLine(0, 0, OFF) != OK))
+		{
+			return ERROR;
+		}
 
-		if (cell == NULL_CELL)
+		if (colCells && (cell->colInfo->onCount >= colCells) &&
+			(forceLine(0, cell->col, OFF) != OK))
+		{
 			return ERROR;
+		}
 
-		free = FALSE;
-		state = 1 - cell->state;
-		cell->state = UNK;
+		return OK;
 	}
-	else
+
+	if (useRow && (cell->row == useRow) && (rowInfo[useRow].onCount == 0))
 	{
-		state = choose(cell);
-		free = TRUE;
+		unknown = colMax - rowInfo[useRow].setCount;
+
+		if (unknown == 0)
+			return ERROR;
+
+		if ((unknown == 1) && (forceLine(useRow, 0, ON) != OK))
+			return ERROR;
 	}
 
-	for (;;)
+	if (useCol && (cell->col == useCol) && (colInfo[useCol].onCount == 0))
 	{
-		/*
-		 * Set the state of the new cell.
-		 */
-		if (go(cell, state, free) != OK)
-			return NOT_EXIST;
+		unknown = rowMax - colInfo[useCol].setCount;
 
-		/*
-		 * If it is time to dump our state, then do that.
-		 */
-		if (dumpFreq && (++dumpcount >= dumpFreq))
-		{
-			dumpcount = 0;
-			dumpState(dumpFile);
-		}
+		if (unknown == 0)
+			return ERROR;
 
-		/*
-		 * If we have enough columns found, then remember to
-		 * write it to the output file.  Also keep the last
-		 * columns count values up to date.
-		 */
-		needWrite = FALSE;
+		if ((unknown == 1) && (forceLine(0, useCol, ON) != OK))
+			return ERROR;
+	}
 
-		if (outputCols &&
-			(fullColumns >= outputLastCols + outputCols))
-		{
-			outputLastCols = fullColumns;
-			needWrite = TRUE;
-		}
+	return OK;
+}
 
-		if (outputLastCols > fullColumns)
-			outputLastCols = fullColumns;
 
-		/*
-		 * If it is time to view the progress,then show it.
-		 */
+/*
+ * Check that the row and column which must be used can still be used
+ * once the initial commands are done, since the cells set before then
+ * are not checked.  Returns FALSE if either of them is completely set
+ * without any ON cells.
+ */
+Bool
+usableLines(void)
+{
+	if (useRow && (rowInfo[useRow].onCount == 0) &&
+		(rowInfo[useRow].setCount == colMax))
+	{
+		return FALSE;
+	}
+
+	if (useCol && (colInfo[useCol].onCount == 0) &&
+		(colInfo[useCol].setCount == rowMax))
+	{
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+
+/*
+ * Force the unknown cells of generation 0 to the specified state within
+ * the specified row, or within the specified column, or everywhere if
+ * both are zero.  Returns ERROR if a cell cannot be set.
+ */
+static Status
+forceLine(int row, int col, State state)
+{
+	int	minRow;
+	int	maxRow;
+	int	minCol;
+	int	maxCol;
+	Cell *	cell;
+
+	minRow = row ? row : 1;
+	maxRow = row ? row : rowMax;
+	minCol = col ? col : 1;
+	maxCol = col ? col : colMax;
+
+	for (row = minRow; row <= maxRow; row++)
+		for (col = minCol; col <= maxCol; col++)
+	{
+		cell = findCell(row, col, 0);
+
+		if ((cell->state == UNK) && (setCell(cell, state, FALSE) != OK))
+			return ERROR;
+	}
+
+	return OK;
+}
+
+
+/*
+ * Check a column whose cells of all generations have just become known.
+ * Together with the column before it, it must have some possible next
+ * column which agrees with the known cells there.  If the column after
+ * it is also complete, then the same check is done for that column.
+ * Returns ERROR if there is no possible next column.
+ */
+static Status
+checkLookup(int col)
+{
+	if (checkNextColumn(col) != OK)
+		return ERROR;
+
+	if ((col < colMax) && (colKnown[col + 1] == rowMax * genMax))
+		return checkNextColumn(col + 1);
+
+	return OK;
+}
+
+
+/*
+ * Check that the known cells of the column after the specified complete
+ * column agree with one of the columns which can follow it.  The cells
+ * of the last generation must make the cells of generation 0 which they
+ * map to, except when only looking for parents.  If the previous column
+ * is not complete, or if there are too many possible next columns, then
+ * nothing is checked.
+ */
+static Status
+checkNextColumn(int col)
+{
+	const RowBits *	list;
+	RowBits		left[GEN_MAX];
+	RowBits		middle[GEN_MAX];
+	RowBits		nextBits[GEN_MAX];
+	RowBits		nextMask[GEN_MAX];
+	RowBits		wrapBits;
+	RowBits		wrapMask;
+	RowBits		bit;
+	Cell *		cell;
+	int		count;
+	int		row;
+	int		gen;
+	int		i;
+
+	if ((col > 1) && (colKnown[col - 1] != rowMax * genMax))
+		return OK;
+
+	for (gen = 0; gen < genMax; gen++)
+	{
+		left[gen] = 0;
+		middle[gen] = 0;
+		nextBits[gen] = 0;
+		nextMask[gen] = 0;
+
+		for (row = 1; row <= rowMax; row++)
+		{
+			bit = (1ULL << row);
+
+			if (findCell(row, col - 1, gen)->state == ON)
+				left[gen] |= bit;
+
+			if (findCell(row, col, gen)->state == ON)
+				middle[gen] |= bit;
+
+			cell = findCell(row, col + 1, gen);
+
+			if (cell->state != UNK)
+				nextMask[gen] |= bit;
+
+			if (cell->state == ON)
+				nextBits[gen] |= bit;
+		}
+	}
+
+	wrapBits = 0;
+	wrapMask = 0;
+
+	for (row = 0; !parent && (row <= rowMax + 1); row++)
+	{
+		cell = findCell(row, col, genMax - 1)->future;
+		bit = (1ULL << row);
+
+		if (cell->state != UNK)
+			wrapMask |= bit;
+
+		if (cell->state == ON)
+			wrapBits |= bit;
+	}
+
+	list = findColumns(genMax, left, middle, wrapBits, wrapMask,
+		LOOKUP_LIMIT, &count);
+
+	if (list == NULL)
+		return OK;
+
+	for (i = 0; i < count; i++, list += genMax)
+	{
+		for (gen = 0; gen < genMax; gen++)
+		{
+			if ((list[gen] ^ nextBits[gen]) & nextMask[gen])
+				break;
+		}
+
+		if (gen == genMax)
+			return OK;
+	}
+
+	DPRINTF1("Column %d has no possible next column\n", col);
+
+	return ERROR;
+}
+
+
+/*
+ * Examine the next choice of cell settings.
+ */
+static Status
+examineNext(void)
+{
+	Cell *	cell;
+
+	/*
+	 * If there are no more cells to examine, then what we have
+	 * is consistent.
+	 */
+	if (nextSet == newSet)
+		return CONSISTENT;
+
+	/*
+	 * Get the next cell to examine, and check it out for symmetry
+	 * and for consistency with its previous and next generations.
+	 */
+	cell = *nextSet++;
+
+	DPRINTF4("Examining saved cell %d %d %d (%s) for consistency\n",
+		cell->row, cell->col, cell->gen,
+		(cell->free ? "free" : "forced"));
+
+	if (cell->loop && (setCell(cell->loop, cell->state, FALSE) != OK))
+	{
+		return ERROR;
+	}
+
+	if ((cell->phaseIndex >= 0) && (checkPhase(cell) != OK))
+		return ERROR;
+
+	if (edgeCheck && ((cell->row == 1) || (cell->col == 1) ||
+		(cell->row == rowMax) || (cell->col == colMax)) &&
+		(checkEdges() != OK))
+	{
+		return ERROR;
+	}
+
+	if (periodTight && (checkPeriods() != OK))
+		return ERROR;
+
+	if (colWidth && (cell->gen == 0) && (cell->state == ON) && inited &&
+		(forceWidth(cell) != OK))
+	{
+		return ERROR;
+	}
+
+	if (nearCols && (cell->gen == 0) && (cell->state == OFF) && inited &&
+		(forceNear(cell) != OK))
+	{
+		return ERROR;
+	}
+
+	if (useCounts && (cell->gen == 0) && inited &&
+		(checkCounts(cell) != OK))
+	{
+		return ERROR;
+	}
+
+	if (useLookup && (colDone[cell->col] == cell) && inited &&
+		(colKnown[cell->col] == rowMax * genMax) &&
+		(checkLookup(cell->col) != OK))
+	{
+		return ERROR;
+	}
+
+	return consistify10(cell);
+}
+
+
+/*
+ * Set a cell to the specified value and determine all consequences we
+ * can from the choice.  Consequences are a contradiction or a consistency.
+ */
+Status
+proceed(Cell * cell, State state, Bool free)
+{
+	int	status;
+
+	if (setCell(cell, state, free) != OK)
+	{
+		/*
+		 * If a chosen state is rejected outright, the cell never
+		 * gets onto the setting table, so backing up would not try
+		 * the other state.  So that state is forced here instead.
+		 */
+		if (!free || (setCell(cell, 1 - state, FALSE) != OK))
+			return ERROR;
+	}
+
+	for (;;)
+	{
+		status = examineNext();
+
+		if (status == ERROR)
+			return ERROR;
+
+		if (status == CONSISTENT)
+			return OK;
+	}
+}
+
+
+/*
+ * Back up the list of set cells to undo choices.
+ * Returns the cell which is to be tried for the other possibility.
+ * Returns NULL_CELL on an "object cannot exist" error.
+ */
+Cell *
+backup(void)
+{
+	Cell *	cell;
+
+	while (newSet != baseSet)
+	{
+		/*
+		 * Stop at a column pattern choice so that its next
+		 * pattern can be tried.
+		 */
+		if (atChoice())
+			break;
+
+		cell = *--newSet;
+
+		DPRINTF5("backing up cell %d %d %d, was %s, %s\n",
+			cell->row, cell->col, cell->gen,
+			((cell->state == ON) ? "on" : "off"),
+			(cell->free ? "free": "forced"));
+
+		unsetCell(cell);
+
+		if (!cell->free)
+		{
+			cell->state = UNK;
+			cell->free = TRUE;
+
+			continue;
+		}
+
+		/*
+		 * The state chosen for this cell has now been refuted.
+		 */
+		if (learnValues)
+			learnValue(cell, 1 - cell->state, VALUE_REFUTE);
+
+		backtrackCount++;
+		nextSet = newSet;
+		undoRules();
+
+		return cell;
+	}
+
+	nextSet = newSet;
+	undoRules();
+	return NULL_CELL;
+}
+
+
+/*
+ * Undo the bookkeeping done by setCell for a cell taken off the setting
+ * table.  The state of the cell is left alone for the caller to handle.
+ */
+static void
+unsetCell(Cell * cell)
+{
+	int	gen;
+	int	i;
+
+	if ((cell->state == ON) && (cell->gen == 0))
+	{
+		cell->rowInfo->onCount--;
+		cell->colInfo->sumPos -= cell->row;
+		cellCount--;
+		cell->colInfo->onRows &= ~(1ULL << cell->row);
+		cell->colInfo->needRows &= ~(1ULL << cell->row);
+
+		if (colWidth)
+		{
+			widthDepth--;
+
+			for (i = 0; i < 2; i++)
+			{
+				cell->colInfo->minRow[i] = widthStack[widthDepth][i];
+				cell->colInfo->maxRow[i] =
+					widthStack[widthDepth][i + 2];
+			}
+		}
+
+		if (--cell->colInfo->onCount == 0)
+		{
+			onColumns[cell->col / LONG_BITS] &=
+				~(1UL << (cell->col % LONG_BITS));
+		}
+	}
+
+	if ((cell->gen == 0) && (cell->colInfo->setCount == cell->colInfo->cells))
+		fullColumns--;
+
+	if (useLookup)
+		colKnown[cell->col]--;
+
+	cell->rowInfo->setCount--;
+	cell->colInfo->setCount--;
+
+	if (nearCols)
+		cell->colInfo->unkRows |= (1ULL << cell->row);
+
+	if (periodGen[cell->gen])
+		genKnown[cell->gen]--;
+
+	if (edgeCheck)
+		countEdges(cell, cell->state, -1);
+
+	/*
+	 * The cell is about to become unknown again, even if it
+	 * is the free cell which the caller immediately resets.
+	 */
+	if (orderDynamic)
+		adjustKnown(cell, -1);
+
+	if (useHeap && (cell->rank >= 0) && cell->choose)
+		heapInsert(cell);
+
+	/*
+	 * Phase positions after this cell are no longer decided.
+	 */
+	if (cell->phaseIndex >= 0)
+	{
+		for (gen = 1; gen < genMax; gen++)
+		{
+			if (((cell->gen == 0) || (cell->gen == gen)) &&
+				(phasePos[gen] > cell->phaseIndex))
+			{
+				phasePos[gen] = cell->phaseIndex;
+			}
+		}
+	}
+
+	/*
+	 * Keep the search list starting no later than this cell, so that
+	 * all cells ahead of the search list are always known.
+	 */
+	if ((cell->rank >= 0) && (cell->rank < searchList->rank))
+		searchList = cell;
+}
+
+
+/*
+ * Restart the search from the beginning.  All settings made by the
+ * search are undone, the search order is shuffled again, and unless
+ * told to keep them, everything learned about the cells is forgotten.
+ */
+static void
+restart(void)
+{
+	Cell *	cell;
+
+	DPRINTF1("restarting search after %ld backtracks\n", backtrackCount);
+
+	while (newSet != baseSet)
+	{
+		cell = *--newSet;
+		unsetCell(cell);
+		cell->state = UNK;
+		cell->free = TRUE;
+	}
+
+	nextSet = baseSet;
+	choiceCount = 0;
+	undoRules();
+
+	if (!restartKeep)
+	{
+		for (cell = fullSearchList; cell; cell = cell->search)
+		{
+			cell->activity = 0;
+			cell->valueScore = 0;
+		}
+	}
+
+	initSearchOrder();
+
+	if (useHeap)
+		initHeap();
+
+	restartCount++;
+	backtrackCount = 0;
+	restartLimit = getRestartLimit();
+}
+
+
+/*
+ * Get the state of the restarts so that it can be dumped.  This is the
+ * number of restarts, the backtracks since the last one and before the
+ * next one, and the random states when the search order was shuffled
+ * and now.
+ */
+void
+getRestarts(long * count, long * backtracks, long * limit,
+	unsigned long * order, unsigned long * state)
+{
+	*count = restartCount;
+	*backtracks = backtrackCount;
+	*limit = restartLimit;
+	*order = orderState;
+	*state = randomState;
+}
+
+
+/*
+ * Set the state of the restarts from a dump, after the cells have been
+ * set.  The search order is shuffled again as it was on the last restart.
+ */
+void
+setRestarts(long count, long backtracks, long limit, unsigned long order,
+	unsigned long state)
+{
+	restartCount = count;
+	backtrackCount = backtracks;
+	restartLimit = limit;
+
+	if (count)
+	{
+		randomState = order;
+		initSearchOrder();
+
+		if (useHeap)
+			initHeap();
+	}
+
+	randomState = state;
+}
+
+
+/*
+ * Return the number of backtracks allowed before the next restart.
+ * This is either the Luby sequence 1 1 2 1 1 2 4 1 1 2 ... or else
+ * a geometric sequence increasing by half each time, multiplied by
+ * the restart frequency.
+ */
+static long
+getRestartLimit(void)
+{
+	long	limit;
+	long	i;
+	int	k;
+
+	if (restartGeom)
+	{
+		limit = restartFreq;
+
+		for (i = 0; (i < restartCount) && (limit < 1000000000L); i++)
+			limit = (limit * 3) / 2 + 1;
+
+		return limit;
+	}
+
+	i = restartCount + 1;
+
+	for (;;)
+	{
+		for (k = 1; ((1L << k) - 1) < i; k++)
+			;
+
+		if (((1L << k) - 1) == i)
+			break;
+
+		i -= (1L << (k - 1)) - 1;
+	}
+
+	return (1L << (k - 1)) * restartFreq;
+}
+
+
+/*
+ * Do checking based on setting the specified cell.  If the cell is
+ * NULL_CELL, then the next pattern of the latest column pattern choice
+ * is set instead.  Returns ERROR if an inconsistency was found.
+ */
+Status
+go(Cell * cell, State state, Bool free)
+{
+	Status	status;
+
+	quitOk = FALSE;
+
+	for (;;)
+	{
+		if (cell == NULL_CELL)
+			status = nextPattern();
+		else
+			status = proceed(cell, state, free);
+
+		if (status == OK)
+			return OK;
+
+		cell = backup();
+
+		if (cell == NULL_CELL)
+		{
+			if (!atChoice())
+				return ERROR;
+
+			continue;
+		}
+
+		free = FALSE;
+		state = 1 - cell->state;
+		cell->state = UNK;
+	}
+}
+
+
+/*
+ * Start choosing the pattern of the unknown cells of generation 0 in
+ * the specified column which are in the search order.  The patterns
+ * are then set by calling go with NULL_CELL.
+ */
+static void
+startPattern(int col)
+{
+	Choice *	choice;
+	const Cell *	cell;
+	int		row;
+
+	choice = &choiceTable[choiceCount++];
+	choice->mark = newSet;
+	choice->col = col;
+	choice->rows = 0;
+	choice->pattern = 0;
+	choice->started = FALSE;
+
+	for (row = 1; row <= rowMax; row++)
+	{
+		cell = findCell(row, col, 0);
+
+		if ((cell->state == UNK) && cell->choose && (cell->rank >= 0))
+			choice->rows |= (1ULL << row);
+	}
+}
+
+
+/*
+ * Set the next pattern of the latest column pattern choice which is
+ * consistent.  The cells of the pattern are set a row at a time, and
+ * the cells which they force are found before the next row is set.
+ * When a row fails, every pattern which agrees with it on the rows
+ * so far fails too, so they are skipped without setting them.  Returns
+ * OK if a pattern was set, or ERROR with the choice removed if there
+ * are no more.
+ */
+static Status
+nextPattern(void)
+{
+	Choice *	choice;
+	Cell *		cell;
+	Cell **		rowMark[ROW_MAX + 2];
+	RowBits		oldPattern;
+	Status		status;
+	int		row;
+
+	choice = &choiceTable[choiceCount - 1];
+	row = rowMax;
+
+	for (;;)
+	{
+		/*
+		 * Step to the next pattern, starting with all of the
+		 * cells OFF, and skipping the rest of the patterns which
+		 * agree with the current one up to the row which failed.
+		 * The rows above the first one which changes are still
+		 * set from the last pattern which was tried here.
+		 */
+		oldPattern = choice->pattern;
+
+		if (!choice->started)
+		{
+			choice->started = TRUE;
+			row = 1;
+		}
+		else if (!stepPattern(choice, row))
+			break;
+		else if (newSet == choice->mark)
+			row = 1;
+		else
+		{
+			for (row = 1; ((oldPattern ^ choice->pattern) &
+				(1ULL << row)) == 0; row++)
+			{
+				;
+			}
+
+			backTo(rowMark[row]);
+		}
+
+		status = OK;
+
+		for (; row <= rowMax; row++)
+		{
+			if ((choice->rows & (1ULL << row)) == 0)
+				continue;
+
+			rowMark[row] = newSet;
+			cell = findCell(row, choice->col, 0);
+			status = setCell(cell, (choice->pattern & (1ULL << row)) ?
+				ON : OFF, FALSE);
+
+			while (status == OK)
+				status = examineNext();
+
+			if (status != CONSISTENT)
+				break;
+		}
+
+		if (row > rowMax)
+			return OK;
+
+		backtrackCount++;
+	}
+
+	/*
+	 * There are no more patterns, so undo the last one.
+	 */
+	backTo(choice->mark);
+	choiceCount--;
+
+	return ERROR;
+}
+
+
+/*
+ * Undo the settings of cells back to the specified position in the
+ * setting table.
+ */
+static void
+backTo(Cell ** mark)
+{
+	Cell *	cell;
+
+	while (newSet != mark)
+	{
+		cell = *--newSet;
+		unsetCell(cell);
+		cell->state = UNK;
+		cell->free = TRUE;
+	}
+
+	nextSet = newSet;
+	undoRules();
+}
+
+
+/*
+ * Step the pattern of a column pattern choice to the next one which
+ * differs from it in the specified row or above.  The rows nearer the
+ * top of the column change the most slowly, and each row is OFF before
+ * it is ON.  Returns FALSE if there are no more patterns.
+ */
+static Bool
+stepPattern(Choice * choice, int lastRow)
+{
+	RowBits	bit;
+	int	row;
+
+	for (row = lastRow; row >= 1; row--)
+	{
+		bit = (1ULL << row);
+
+		if ((choice->rows & bit) && !(choice->pattern & bit))
+		{
+			choice->pattern = (choice->pattern | bit) &
+				((bit << 1) - 1);
+
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+
+/*
+ * Return whether backing up has stopped at a column pattern choice,
+ * whose next pattern should then be tried.
+ */
+Bool
+atChoice(void)
+{
+	return ((choiceCount > 0) &&
+		(choiceTable[choiceCount - 1].mark == newSet));
+}
+
+
+/*
+ * Find another unknown cell in a normal search.
+ * Returns NULL_CELL if there are no more unknown cells.
+ */
+static Cell *
+getNormalUnknown(void)
+{
+	Cell *	cell;
+
+	for (cell = searchList; cell; cell = cell->search)
+	{
+		if (!cell->choose)
+			continue;
+
+		if (cell->state == UNK)
+		{
+			searchList = cell;
+
+			return cell;
+		}
+	}
+
+	return NULL_CELL;
+}
+
+
+/*
+ * Find another unknown cell when averaging is done.
+ * Returns NULL_CELL if there are no more unknown cells.
+ */
+static Cell *
+getAverageUnknown(void)
+{
+	Cell *	cell;
+	Cell *	bestCell;
+	int	bestDist;
+	int	curDist;
+	int	wantRow;
+	int	curCol;
+	int	testCol;
+
+	bestCell = NULL_CELL;
+	bestDist = -1;
+
+	cell = searchList;
+
+	while (cell)
+	{
+		searchList = cell;
+		curCol = cell->col;
+
+		testCol = prevOnColumn(curCol);
+
+		if (testCol > 0)
+		{
+			wantRow = colInfo[testCol].sumPos /
+				colInfo[testCol].onCount;
+		}
+		else
+			wantRow = (rowMax + 1) / 2;
+
+		for (; cell && (cell->col == curCol); cell = cell->search)
+		{
+			if (!cell->choose)
+				continue;
+
+			if (cell->state == UNK)
+			{
+				curDist = cell->row - wantRow;
+
+				if (curDist < 0)
+					curDist = -curDist;
+
+				if (curDist > bestDist)
+				{
+					bestCell = cell;
+					bestDist = curDist;
+				}
+			}
+		}
+
+		if (bestCell)
+			return bestCell;
+	}
+
+	return NULL_CELL;
+}
+
+
+/*
+ * Return the nearest column before the specified one which has any
+ * ON cells in generation 0, or 0 if there is no such column.
+ */
+static int
+prevOnColumn(int col)
+{
+	int		word;
+	int		bit;
+	unsigned long	bits;
+
+	if (--col <= 0)
+		return 0;
+
+	word = col / LONG_BITS;
+	bits = onColumns[word] & (~0UL >> (LONG_BITS - 1 - (col % LONG_BITS)));
+
+	while (bits == 0)
+	{
+		if (--word < 0)
+			return 0;
+
+		bits = onColumns[word];
+	}
+
+	bit = LONG_BITS - 1;
+
+	while ((bits & (1UL << bit)) == 0)
+		bit--;
+
+	return word * LONG_BITS + bit;
+}
+
+
+/*
+ * Find the best unknown cell for a dynamically ordered search.
+ * This is the cell with the highest activity when ordering by conflicts,
+ * or else the cell with the most known cells in its light cone, with ties
+ * broken by the normal search order.  Cells which have been excluded from
+ * the search since they were put into the heap are discarded here.
+ * Returns NULL_CELL if there are no more unknown cells.
+ */
+static Cell *
+getDynamicUnknown(void)
+{
+	Cell *	cell;
+
+	while (heapCount > 0)
+	{
+		cell = heap[1];
+
+		if (cell->choose)
+			return cell;
+
+		heapRemove(cell);
+	}
+
+	return NULL_CELL;
+}
+
+
+/*
+ * Choose a state for an unknown cell, either OFF or ON.
+ * Normally, we try to choose OFF cells first to terminate an object.
+ * But for follow generations mode, we try to choose the same setting
+ * as a nearby generation.
+ */
+static State
+choose(const Cell * cell)
+{
+	/*
+	 * If we are learning values, then use the one which
+	 * has worked best so far.
+	 */
+	if (learnValues)
+	{
+		if (cell->valueScore > 0)
+			return ON;
+
+		if (cell->valueScore < 0)
+			return OFF;
+	}
+
+	/*
+	 * If the cell was hinted, then use that state.
+	 */
+	if (cell->hint != UNK)
+		return cell->hint;
+
+	/*
+	 * If we are following cells in other generations,
+	 * then try to do that.
+	 */
+	if (followGens)
+	{
+		if ((cell->past->state == ON) ||
+			(cell->future->state == ON))
+		{
+			return ON;
+		}
+
+		if ((cell->past->state == OFF) ||
+			(cell->future->state == OFF))
+		{
+			return OFF;
+		}
+	}
+
+	/*
+	 * If there is nothing known about the cell, then
+	 * pick randomly if a seed was given or when restarting.
+	 */
+	if ((learnValues && randomSeed) || restartFreq)
+		return (randomNumber() & 0x01) ? ON : OFF;
+
+	return OFF;
+}
+
+
+/*
+ * Adjust the learned value score of a cell towards the specified state.
+ */
+static void
+learnValue(Cell * cell, State state, int weight)
+{
+	if (state == OFF)
+		weight = -weight;
+
+	cell->valueScore += weight;
+
+	if (cell->valueScore > VALUE_LIMIT)
+		cell->valueScore = VALUE_LIMIT;
+
+	if (cell->valueScore < -VALUE_LIMIT)
+		cell->valueScore = -VALUE_LIMIT;
+}
+
+
+/*
+ * Reward the states of all the free cells which led to a found object.
+ */
+static void
+learnFound(void)
+{
+	Cell **	set;
+	Cell *	cell;
+
+	for (set = setTable; set != nextSet; set++)
+	{
+		cell = *set;
+
+		if (cell->free)
+			learnValue(cell, cell->state, VALUE_FOUND);
+	}
+}
+
+
+/*
+ * Return a random number from 0 to 32767.  This is a simple linear
+ * congruential generator, so that searches using the same seed are
+ * reproducible everywhere.  The bits used do not depend on the size
+ * of a long.
+ */
+static int
+randomNumber(void)
+{
+	randomState = randomState * 1103515245L + 12345;
+
+	return (int) ((randomState >> 16) & 0x7fff);
+}
+
+
+/*
+ * The top level search routine.
+ * Returns if an object is found, or is impossible.
+ */
+Status
+search(void)
+{
+	Cell *	cell;
+	Bool	free;
+	Bool	needWrite;
+	State	state;
+
+	cell = (*getUnknown)();
+	state = OFF;
+	free = FALSE;
+
+	if (cell == NULL_CELL)
+	{
+		cell = backup();
+
+		if ((cell == NULL_CELL) && !atChoice())
+			return ERROR;
+
+		if (cell != NULL_CELL)
+		{
+			state = 1 - cell->state;
+			cell->state = UNK;
+		}
+	}
+	else if (orderColumns && (cell->gen == 0))
+	{
+		startPattern(cell->col);
+		cell = NULL_CELL;
+	}
+	else
+	{
+		state = choose(cell);
+		free = TRUE;
+	}
+
+	for (;;)
+	{
+		/*
+		 * Set the state of the new cell.
+		 */
+		if (go(cell, state, free) != OK)
+			return NOT_EXIST;
+
+		/*
+		 * If it is time to dump our state, then do that.
+		 */
+		if (dumpFreq && (++dumpcount >= dumpFreq))
+		{
+			dumpcount = 0;
+			dumpState(dumpFile);
+		}
+
+		/*
+		 * If we have enough columns found, then remember to
+		 * write it to the output file.  Also keep the last
+		 * columns count values up to date.
+		 */
+		needWrite = FALSE;
+
+		if (outputCols &&
+			(fullColumns >= outputLastCols + outputCols))
+		{
+			outputLastCols = fullColumns;
+			needWrite = TRUE;
+		}
+
+		if (outputLastCols > fullColumns)
+			outputLastCols = fullColumns;
+
+		/*
+		 * If it is time to view the progress,then show it.
+		 */
 		if (needWrite || (viewFreq && (++viewCount >= viewFreq)))
 		{
 			viewCount = 0;
@@ -1090,127 +2747,549 @@ search(void)
 		if (ttyCheck())
 			getCommands();
 
-		/*
-		 * Get the next unknown cell and choose its state.
-		 */
-		cell = (*getUnknown)();
+		/*
+		 * If the search has backtracked too much since the
+		 * last restart, then start again from the beginning.
+		 */
+		if (restartLimit && (backtrackCount >= restartLimit))
+			restart();
+
+		/*
+		 * Get the next unknown cell and choose its state.
+		 */
+		cell = (*getUnknown)();
+
+		if (cell == NULL_CELL)
+		{
+			if (learnValues)
+				learnFound();
+
+			/*
+			 * Restarting from now on would find objects again,
+			 * so stop restarting once something has been found.
+			 */
+			restartLimit = 0;
+
+			return FOUND;
+		}
+
+		/*
+		 * When choosing whole columns, a cell of generation 0
+		 * starts a choice of the pattern of its column.
+		 */
+		if (orderColumns && (cell->gen == 0))
+		{
+			startPattern(cell->col);
+			cell = NULL_CELL;
+
+			continue;
+		}
+
+		state = choose(cell);
+		free = TRUE;
+	}
+}
+
+
+/*
+ * Check whether the specified cell of generation 0 can be near enough to
+ * an ON cell in the previous columns to be set ON.  This is true if there
+ * is an ON or unknown cell within the nearCols distance of its row in any
+ * of the nearCols previous columns.  If the cells are only unknown, then
+ * forceNear fails once the last of them is set OFF.
+ */
+static Bool
+checkNear(const Cell * cell)
+{
+	RowBits	rows;
+	int	col;
+
+	rows = 0;
+
+	for (col = cell->col - nearCols; col < cell->col; col++)
+	{
+		if (col >= 1)
+			rows |= colInfo[col].onRows | colInfo[col].unkRows;
+	}
+
+	return ((rows & nearMask[cell->row]) != 0);
+}
+
+
+/*
+ * Check the cells of generation 0 in the next columns which could have
+ * been near the specified cell which has just been set OFF, and which now
+ * have no ON or unknown cells near enough to them in the previous columns.
+ * Such unknown cells can never be set ON, so they are forced OFF.  Returns
+ * ERROR if such a cell is already ON, or if a cell cannot be set.
+ */
+static Status
+forceNear(const Cell * cell)
+{
+	RowBits	rows;
+	RowBits	near;
+	RowBits	lost;
+	int	col;
+	int	prevCol;
+	int	row;
+	int	i;
+
+	for (col = cell->col + 1; col <= cell->col + nearCols; col++)
+	{
+		if (col > colMax)
+			break;
+
+		lost = (colInfo[col].unkRows | colInfo[col].needRows) &
+			nearMask[cell->row];
+
+		if (lost == 0)
+			continue;
+
+		rows = 0;
+
+		for (prevCol = col - nearCols; prevCol < col; prevCol++)
+		{
+			if (prevCol >= 1)
+			{
+				rows |= colInfo[prevCol].onRows |
+					colInfo[prevCol].unkRows;
+			}
+		}
+
+		near = rows;
+
+		for (i = 1; i <= nearCols; i++)
+			near |= (rows << i) | (rows >> i);
+
+		lost &= ~near;
+
+		if (lost & colInfo[col].needRows)
+			return ERROR;
+
+		for (row = 1; lost; row++)
+		{
+			if ((lost & (1ULL << row)) == 0)
+				continue;
+
+			lost &= ~(1ULL << row);
+
+			if (setCell(findCell(row, col, 0), OFF, FALSE) != OK)
+				return ERROR;
+		}
+	}
+
+	return OK;
+}
+
+
+/*
+ * Initialize the known counts of all cells to be searched, and put the
+ * ones which are still unknown into the heap.
+ */
+static void
+initHeap(void)
+{
+	Cell *	cell;
+
+	heapCount = 0;
+
+	for (cell = fullSearchList; cell; cell = cell->search)
+	{
+		if (orderDynamic)
+			cell->known = countKnown(cell);
+
+		cell->heapPos = 0;
+
+		if ((cell->state == UNK) && cell->choose)
+			heapInsert(cell);
+	}
+}
+
+
+/*
+ * Count the known cells which affect the specified cell.  These are its
+ * neighbors, the cells in the previous generation which determine its
+ * state, and the cell in the next generation which it helps to determine.
+ */
+static int
+countKnown(const Cell * cell)
+{
+	const Cell *	prev;
+	int		count;
+
+	prev = cell->past;
+
+	count = (cell->future->state != UNK);
+
+	count += (cell->cul->state != UNK) + (cell->cu->state != UNK);
+	count += (cell->cur->state != UNK) + (cell->cl->state != UNK);
+	count += (cell->cr->state != UNK) + (cell->cdl->state != UNK);
+	count += (cell->cd->state != UNK) + (cell->cdr->state != UNK);
+
+	count += (prev->state != UNK);
+	count += (prev->cul->state != UNK) + (prev->cu->state != UNK);
+	count += (prev->cur->state != UNK) + (prev->cl->state != UNK);
+	count += (prev->cr->state != UNK) + (prev->cdl->state != UNK);
+	count += (prev->cd->state != UNK) + (prev->cdr->state != UNK);
+
+	return count;
+}
+
+
+/*
+ * Adjust the known counts of all the cells whose count includes the
+ * specified cell.  This is the reverse of the relation used in countKnown.
+ */
+static void
+adjustKnown(Cell * cell, int inc)
+{
+	bumpKnown(cell->past, inc);
+	bumpKnown(cell->future, inc);
+	bumpKnown(cell->cul, inc);
+	bumpKnown(cell->cu, inc);
+	bumpKnown(cell->cur, inc);
+	bumpKnown(cell->cl, inc);
+	bumpKnown(cell->cr, inc);
+	bumpKnown(cell->cdl, inc);
+	bumpKnown(cell->cd, inc);
+	bumpKnown(cell->cdr, inc);
+	bumpKnown(cell->cul->future, inc);
+	bumpKnown(cell->cu->future, inc);
+	bumpKnown(cell->cur->future, inc);
+	bumpKnown(cell->cl->future, inc);
+	bumpKnown(cell->cr->future, inc);
+	bumpKnown(cell->cdl->future, inc);
+	bumpKnown(cell->cd->future, inc);
+	bumpKnown(cell->cdr->future, inc);
+}
+
+
+/*
+ * Change the known count of one cell, keeping the heap in order.
+ */
+static void
+bumpKnown(Cell * cell, int inc)
+{
+	cell->known += inc;
+
+	if (cell->heapPos)
+		heapAdjust(cell);
+}
+
+
+/*
+ * Increase the activity of a cell, keeping the heap in order.
+ * Cells which are never searched are ignored.
+ */
+static void
+bumpActivity(Cell * cell)
+{
+	if (cell->rank < 0)
+		return;
+
+	cell->activity += ACTIVITY_BUMP;
+
+	if (cell->heapPos)
+		heapAdjust(cell);
+}
+
+
+/*
+ * Halve the activity of all cells to be searched.  Since the blending
+ * with the search order does not decay, the heap has to be rebuilt.
+ */
+static void
+decayActivity(void)
+{
+	Cell *	cell;
+
+	heapCount = 0;
+
+	for (cell = fullSearchList; cell; cell = cell->search)
+	{
+		cell->activity /= 2;
+
+		if (cell->heapPos)
+		{
+			cell->heapPos = 0;
+			heapInsert(cell);
+		}
+	}
+}
+
+
+/*
+ * Return the key used for ordering a cell by its activity.
+ * This is the activity of the cell plus a bonus for being early in the
+ * normal search order.  The bonus for the first cell to be searched is
+ * worth the given number of conflicts, and drops to zero for the last one.
+ */
+static int
+activityKey(const Cell * cell)
+{
+	return cell->activity + (int) (((long) activityBlend * ACTIVITY_BUMP *
+		(searchCount - cell->rank)) / searchCount);
+}
+
+
+/*
+ * Return TRUE if the first cell should be searched before the second one.
+ */
+static Bool
+heapBetter(const Cell * c1, const Cell * c2)
+{
+	int	key1;
+	int	key2;
+
+	if (orderActivity)
+	{
+		key1 = activityKey(c1);
+		key2 = activityKey(c2);
+
+		if (key1 != key2)
+			return (key1 > key2);
+	}
+
+	if (c1->known != c2->known)
+		return (c1->known > c2->known);
+
+	return (c1->rank < c2->rank);
+}
+
+
+/*
+ * Insert a cell into the heap of unknown cells.
+ */
+static void
+heapInsert(Cell * cell)
+{
+	if (cell->heapPos)
+		return;
+
+	heap[++heapCount] = cell;
+	cell->heapPos = heapCount;
+	heapAdjust(cell);
+}
+
+
+/*
+ * Remove a cell from the heap of unknown cells.
+ * The last cell of the heap is moved into its place.
+ */
+static void
+heapRemove(Cell * cell)
+{
+	Cell *	last;
+	int	pos;
+
+	pos = cell->heapPos;
+	cell->heapPos = 0;
+	last = heap[heapCount--];
+
+	if (last == cell)
+		return;
+
+	heap[pos] = last;
+	last->heapPos = pos;
+	heapAdjust(last);
+}
+
+
+/*
+ * Move a cell up or down in the heap to restore the heap ordering
+ * after its priority has changed.
+ */
+static void
+heapAdjust(Cell * cell)
+{
+	Cell *	other;
+	int	pos;
+	int	child;
+
+	pos = cell->heapPos;
+
+	while ((pos > 1) && heapBetter(cell, heap[pos / 2]))
+	{
+		other = heap[pos / 2];
+		heap[pos] = other;
+		other->heapPos = pos;
+		pos /= 2;
+	}
+
+	for (;;)
+	{
+		child = pos * 2;
+
+		if (child > heapCount)
+			break;
+
+		if ((child < heapCount) && heapBetter(heap[child + 1], heap[child]))
+			child++;
+
+		if (!heapBetter(heap[child], cell))
+			break;
+
+		other = heap[child];
+		heap[pos] = other;
+		other->heapPos = pos;
+		pos = child;
+	}
+
+	heap[pos] = cell;
+	cell->heapPos = pos;
+}
+
+
+/*
+ * Check to see if setting the specified cell ON would make the width of
+ * the column exceed the allowed value.  For symmetric objects, the width
+ * is only measured from the center to an edge.  Returns TRUE if the cell
+ * would exceed the value.
+ */
+static Bool
+checkWidth(const Cell * cell)
+{
+	const ColInfo *	info;
+	int		part;
+	int		last;
+	int		minRow;
+	int		maxRow;
+
+	info = cell->colInfo;
+	widthParts(cell, &part, &last);
+
+	for (; part <= last; part++)
+	{
+		minRow = info->minRow[part];
+		maxRow = info->maxRow[part];
+
+		if (cell->row < minRow)
+			minRow = cell->row;
+
+		if (cell->row > maxRow)
+			maxRow = cell->row;
+
+		if (maxRow - minRow >= colWidth)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/*
+ * Find which parts of its column the specified cell of generation 0 is
+ * measured in for the width check.  Part 0 is the whole column, or the
+ * upper half when the halves are measured separately, and part 1 is the
+ * lower half.  The middle row of an odd number of rows is in both halves.
+ */
+static void
+widthParts(const Cell * cell, int * first, int * last)
+{
+	*first = 0;
+	*last = 0;
 
-		if (cell == NULL_CELL)
-			return FOUND;
+	if (!cell->colInfo->halves)
+		return;
 
-		state = choose(cell);
-		free = TRUE;
-	}
+	if (cell->row > (rowMax + 1) / 2)
+		*first = 1;
+
+	if (cell->row > rowMax / 2)
+		*last = 1;
 }
 
 
 /*
- * Increment or decrement the near count in all the cells affected by
- * this cell.  This is done for all cells in the next columns which are
- * within the distance specified the nearCols value.  In this way, a
- * quick test can be made to see if a cell is within range of another one.
+ * Widen the bounds of the ON rows of the column of the specified cell
+ * of generation 0 which is being set ON.  The old bounds are saved on a
+ * stack so that they can be restored when the cell is unset, which is
+ * always done in the reverse order of setting.
  */
-void
-adjustNear(Cell * cell, int inc)
+static void
+adjustWidth(const Cell * cell)
 {
-	Cell *	curCell;
-	int	count;
-	int	colCount;
+	ColInfo *	info;
+	int		part;
+	int		last;
 
-	for (colCount = nearCols; colCount > 0; colCount--)
+	info = cell->colInfo;
+
+	for (part = 0; part < 2; part++)
 	{
-		cell = cell->cr;
-		curCell = cell;
+		widthStack[widthDepth][part] = info->minRow[part];
+		widthStack[widthDepth][part + 2] = info->maxRow[part];
+	}
 
-		for (count = nearCols; count-- >= 0; curCell = curCell->cu)
-			curCell->near += inc;
+	widthDepth++;
 
-		curCell = cell->cd;
+	widthParts(cell, &part, &last);
 
-		for (count = nearCols; count-- > 0; curCell = curCell->cd)
-			curCell->near += inc;
+	for (; part <= last; part++)
+	{
+		if (cell->row < info->minRow[part])
+			info->minRow[part] = cell->row;
+
+		if (cell->row > info->maxRow[part])
+			info->maxRow[part] = cell->row;
 	}
 }
 
 
 /*
- * Check to see if setting the specified cell ON would make the width of
- * the column exceed the allowed value.  For symmetric objects, the width
- * is only measured from the center to an edge.  Returns TRUE if the cell
- * would exceed the value.
+ * Force OFF the unknown cells of generation 0 in the column of the
+ * specified ON cell which are too far from the column's ON cells to
+ * be ON themselves.  Returns ERROR if a cell cannot be set.
  */
-static Bool
-checkWidth(const Cell * cell)
+static Status
+forceWidth(const Cell * cell)
 {
-	int		left;
-	int		width;
+	const ColInfo *	info;
+	Cell *		cp;
+	int		part;
+	int		last;
+	int		row;
 	int		minRow;
 	int		maxRow;
-	int		srcMinRow;
-	int		srcMaxRow;
-	const Cell *	ucp;
-	const Cell *	dcp;
-	Bool		full;
-
-	if (!colWidth || !inited || cell->gen)
-		return FALSE;
+	int		lowRow;
+	int		highRow;
 
-	left = cell->colInfo->onCount;
+	info = cell->colInfo;
+	widthParts(cell, &part, &last);
 
-	if (left <= 0)
-		return FALSE;
-
-	ucp = cell;
-	dcp = cell;
-	width = colWidth;
-	minRow = cell->row;
-	maxRow = cell->row;
-	srcMinRow = 1;
-	srcMaxRow = rowMax;
-	full = TRUE;
-
-	if ((rowSym && (cell->col >= rowSym)) ||
-		(flipRows && (cell->col >= flipRows)))
+	for (; part <= last; part++)
 	{
-		full = FALSE;
-		srcMaxRow = (rowMax + 1) / 2;
+		minRow = 1;
+		maxRow = rowMax;
 
-		if (cell->row > srcMaxRow)
+		if (info->halves)
 		{
-			srcMinRow = (rowMax / 2) + 1;
-			srcMaxRow = rowMax;
+			if (part == 0)
+				maxRow = (rowMax + 1) / 2;
+			else
+				minRow = (rowMax / 2) + 1;
 		}
-	}
 
-	while (left > 0)
-	{
-		if (full && (--width <= 0))
-			return TRUE;
+		lowRow = info->maxRow[part] - colWidth + 1;
+		highRow = info->minRow[part] + colWidth - 1;
 
-		ucp = ucp->cu;
-		dcp = dcp->cd;
-
-		if (ucp->state == ON)
+		for (row = minRow; row <= maxRow; row++)
 		{
-			if (ucp->row >= srcMinRow)
-				minRow = ucp->row;
+			if ((row >= lowRow) && (row <= highRow))
+			{
+				row = highRow;
 
-			left--;
-		}
+				continue;
+			}
 
-		if (dcp->state == ON)
-		{
-			if (dcp->row <= srcMaxRow)
-				maxRow = dcp->row;
+			cp = findCell(row, cell->col, 0);
 
-			left--;
+			if ((cp->state == UNK) && (setCell(cp, OFF, FALSE) != OK))
+				return ERROR;
 		}
 	}
 
-	if (maxRow - minRow >= colWidth)
-		return TRUE;
-
-	return FALSE;
+	return OK;
 }
 
 
@@ -1295,9 +3374,9 @@ mapCell(const Cell * cell, Bool forward)
 	}
 
 	if (forward)
-		return findCell(row, col, 0);
+		return wrapCell(row, col, 0);
 	else
-		return findCell(row, col, genMax - 1);
+		return wrapCell(row, col, genMax - 1);
 }
 
 
@@ -1307,11 +3386,15 @@ mapCell(const Cell * cell, Bool forward)
  * This will force the state of these two cells to follow each other.
  * Symmetry uses this feature, and so does setting stable cells.
  * If any cells in the loop are frozen, then they all are.
+ * Membership of the loops is kept as sets of equal cells, so that
+ * joining loops does not need to walk them.
  */
 void
 loopCells(Cell * cell1, Cell * cell2)
 {
 	Cell *	cell;
+	Cell *	root1;
+	Cell *	root2;
 	Bool	frozen;
 
 	/*
@@ -1324,6 +3407,23 @@ loopCells(Cell * cell1, Cell * cell2)
 	if (cell1 == cell2)
 		return;
 
+	root1 = equalRoot(cell1);
+	root2 = equalRoot(cell2);
+
+	frozen = (root1->frozen || root2->frozen ||
+		cell1->frozen || cell2->frozen);
+
+	/*
+	 * If the cells are already in the same set, then they are
+	 * already in the same loop.
+	 */
+	if (root1 == root2)
+	{
+		root1->frozen = frozen;
+
+		return;
+	}
+
 	/*
 	 * Make the cells belong to their own loop if required.
 	 * This will simplify the code.
@@ -1334,17 +3434,6 @@ loopCells(Cell * cell1, Cell * cell2)
 	if (cell2->loop == NULL)
 		cell2->loop = cell2;
 
-	/*
-	 * See if the second cell is already part of the first cell's loop.
-	 * If so, they they are already joined.  We don't need to
-	 * check the other direction.
-	 */
-	for (cell = cell1->loop; cell != cell1; cell = cell->loop)
-	{
-		if (cell == cell2)
-			return;
-	}
-
 	/*
 	 * The two cells belong to separate loops.
 	 * Break each of those loops and make one big loop from them.
@@ -1354,26 +3443,63 @@ loopCells(Cell * cell1, Cell * cell2)
 	cell2->loop = cell;
 
 	/*
-	 * See if any of the cells in the loop are frozen.
-	 * If so, then mark all of the cells in the loop frozen
-	 * since they effectively are anyway.  This lets the
-	 * user see that fact.
+	 * Join the sets by hanging the shallower tree from the root of
+	 * the deeper one, which then records whether the loop is frozen.
 	 */
-	frozen = cell1->frozen;
-
-	for (cell = cell1->loop; cell != cell1; cell = cell->loop)
+	if (root1->equalRank < root2->equalRank)
 	{
-		if (cell->frozen)
-			frozen = TRUE;
+		cell = root1;
+		root1 = root2;
+		root2 = cell;
 	}
 
-	if (frozen)
-	{
-		cell1->frozen = TRUE;
+	root2->equal = root1;
+
+	if (root1->equalRank == root2->equalRank)
+		root1->equalRank++;
+
+	root1->frozen = frozen;
+}
+
+
+/*
+ * Return the cell which represents the set of cells which are forced
+ * to be equal to the specified cell.  The cells on the way to it are
+ * made to point to it directly so that later lookups are quick.
+ */
+static Cell *
+equalRoot(Cell * cell)
+{
+	Cell *	root;
+	Cell *	next;
 
-		for (cell = cell1->loop; cell != cell1; cell = cell->loop)
-			cell->frozen = TRUE;
+	for (root = cell; root->equal; root = root->equal)
+		;
+
+	while (cell != root)
+	{
+		next = cell->equal;
+		cell->equal = root;
+		cell = next;
 	}
+
+	return root;
+}
+
+
+/*
+ * Return whether the specified cell is frozen, either directly or by
+ * being in the same loop as a frozen cell.
+ */
+Bool
+isFrozen(const Cell * cell)
+{
+	const Cell *	root;
+
+	for (root = cell; root->equal; root = root->equal)
+		;
+
+	return (cell->frozen || root->frozen);
 }
 
 
@@ -1445,9 +3571,217 @@ symCell(const Cell * cell)
 }
 
 
+/*
+ * Replace each loop of symmetrical cells by the first cell of the loop,
+ * so that only that cell holds the state and is examined for all of the
+ * symmetrical positions.  The other positions of the loop are made to
+ * find that cell, and all pointers to the other cells are redirected to
+ * it.  Neighbors of a cell may then be the same cell, which is harmless
+ * since the consistency checks treat them as separate cells.
+ */
+static void
+aliasCells(void)
+{
+	Cell *	cell;
+	int	count;
+	int	i;
+
+	count = (colMax + 2) * (rowMax + 2) * genMax;
+
+	for (i = 0; i < count; i++)
+	{
+		cell = cellTable[i];
+		cell->cul = loopFirst(cell->cul);
+		cell->cu = loopFirst(cell->cu);
+		cell->cur = loopFirst(cell->cur);
+		cell->cl = loopFirst(cell->cl);
+		cell->cr = loopFirst(cell->cr);
+		cell->cdl = loopFirst(cell->cdl);
+		cell->cd = loopFirst(cell->cd);
+		cell->cdr = loopFirst(cell->cdr);
+		cell->past = loopFirst(cell->past);
+		cell->future = loopFirst(cell->future);
+	}
+
+	for (i = 0; i < count; i++)
+		cellTable[i] = loopFirst(cellTable[i]);
+
+	for (i = 0; i < count; i++)
+	{
+		cell = cellTable[i];
+		cell->loop = NULL_CELL;
+		cell->equal = NULL_CELL;
+		cell->equalRank = 0;
+	}
+}
+
+
+/*
+ * Replace the cells of all generations at each frozen position which is
+ * surrounded by two rings of frozen cells or cells outside the search
+ * area by the cell of generation 0 there.  Such a cell is the same in
+ * every generation, so it is set and checked only once, and it is its
+ * own past and future.  Its neighbors are also made the same in every
+ * generation by cells which are all the same in every generation, so
+ * checking them once after it is set is enough too.  Frozen cells
+ * nearer to unfrozen ones stay separate in each generation.  This must
+ * be done before any cells are set.
+ */
+void
+shareCells(void)
+{
+	Cell *	cell;
+	Bool	shared;
+	int	count;
+	int	row;
+	int	col;
+	int	i;
+	int	j;
+
+	for (col = 0; col <= colMax + 1; col++)
+		sharedRows[col] = 0;
+
+	for (col = 1; col <= colMax; col++)
+	{
+		for (row = 1; row <= rowMax; row++)
+		{
+			shared = TRUE;
+
+			for (i = row - 2; i <= row + 2; i++)
+				for (j = col - 2; j <= col + 2; j++)
+			{
+				if ((i >= 1) && (i <= rowMax) && (j >= 1) &&
+					(j <= colMax) && !findCell(i, j, 0)->frozen)
+				{
+					shared = FALSE;
+				}
+			}
+
+			if (shared)
+				sharedRows[col] |= (1ULL << row);
+		}
+	}
+
+	count = (colMax + 2) * (rowMax + 2) * genMax;
+
+	for (i = 0; i < count; i++)
+	{
+		cell = cellTable[i];
+		cell->cul = sharedCell(cell->cul);
+		cell->cu = sharedCell(cell->cu);
+		cell->cur = sharedCell(cell->cur);
+		cell->cl = sharedCell(cell->cl);
+		cell->cr = sharedCell(cell->cr);
+		cell->cdl = sharedCell(cell->cdl);
+		cell->cd = sharedCell(cell->cd);
+		cell->cdr = sharedCell(cell->cdr);
+		cell->past = sharedCell(cell->past);
+		cell->future = sharedCell(cell->future);
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		cell = sharedCell(cellTable[i]);
+
+		if (cell == cellTable[i])
+			continue;
+
+		cellTable[i] = cell;
+		cell->loop = NULL_CELL;
+		cell->equal = NULL_CELL;
+		cell->equalRank = 0;
+	}
+
+	countGenCells();
+	initSearchOrder();
+
+	if (useHeap)
+		initHeap();
+}
+
+
+/*
+ * Return the cell which holds the state of the specified cell when
+ * frozen cells are shared between generations.
+ */
+static Cell *
+sharedCell(Cell * cell)
+{
+	if ((cell == NULL_CELL) || (cell->gen == 0) ||
+		(cell->col < 1) || (cell->col > colMax) ||
+		((sharedRows[cell->col] & (1ULL << cell->row)) == 0))
+	{
+		return cell;
+	}
+
+	return cellTable[(cell->col * (rowMax + 2) + cell->row) * genMax];
+}
+
+
+/*
+ * Count the separate cells of each generation, which is fewer than the
+ * number of positions when cells are shared.
+ */
+static void
+countGenCells(void)
+{
+	const Cell *	cell;
+	int		row;
+	int		col;
+	int		gen;
+
+	for (gen = 0; gen < genMax; gen++)
+	{
+		genCells[gen] = 0;
+
+		for (col = 1; col <= colMax; col++)
+			for (row = 1; row <= rowMax; row++)
+		{
+			cell = findCell(row, col, gen);
+
+			if ((cell->row == row) && (cell->col == col) &&
+				(cell->gen == gen))
+			{
+				genCells[gen]++;
+			}
+		}
+	}
+}
+
+
+/*
+ * Return the first cell of the loop containing the specified cell, which
+ * is the one with the lowest column, and then the lowest row.  A cell
+ * which is not in a loop is returned unchanged.
+ */
+static Cell *
+loopFirst(Cell * cell)
+{
+	Cell *	first;
+	Cell *	loop;
+
+	if ((cell == NULL_CELL) || (cell->loop == NULL_CELL))
+		return cell;
+
+	first = cell;
+
+	for (loop = cell->loop; loop != cell; loop = loop->loop)
+	{
+		if ((loop->col < first->col) ||
+			((loop->col == first->col) && (loop->row < first->row)))
+		{
+			first = loop;
+		}
+	}
+
+	return first;
+}
+
+
 /*
  * Link a cell to its eight neighbors in the same generation, and also
- * link those neighbors back to this cell.
+ * link those neighbors back to this cell.  The neighbors wrap around
+ * when the search area is a torus.
  */
 static void
 linkCell(Cell * cell)
@@ -1461,40 +3795,77 @@ linkCell(Cell * cell)
 	col = cell->col;
 	gen = cell->gen;
 
-	pairCell = findCell(row - 1, col - 1, gen);
+	pairCell = wrapCell(row - 1, col - 1, gen);
 	cell->cul = pairCell;
 	pairCell->cdr = cell;
 
-	pairCell = findCell(row - 1, col, gen);
+	pairCell = wrapCell(row - 1, col, gen);
 	cell->cu = pairCell;
 	pairCell->cd = cell;
 
-	pairCell = findCell(row - 1, col + 1, gen);
+	pairCell = wrapCell(row - 1, col + 1, gen);
 	cell->cur = pairCell;
 	pairCell->cdl = cell;
 
-	pairCell = findCell(row, col - 1, gen);
+	pairCell = wrapCell(row, col - 1, gen);
 	cell->cl = pairCell;
 	pairCell->cr = cell;
 
-	pairCell = findCell(row, col + 1, gen);
+	pairCell = wrapCell(row, col + 1, gen);
 	cell->cr = pairCell;
 	pairCell->cl = cell;
 
-	pairCell = findCell(row + 1, col - 1, gen);
+	pairCell = wrapCell(row + 1, col - 1, gen);
 	cell->cdl = pairCell;
 	pairCell->cur = cell;
 
-	pairCell = findCell(row + 1, col, gen);
+	pairCell = wrapCell(row + 1, col, gen);
 	cell->cd = pairCell;
 	pairCell->cu = cell;
 
-	pairCell = findCell(row + 1, col + 1, gen);
+	pairCell = wrapCell(row + 1, col + 1, gen);
 	cell->cdr = pairCell;
 	pairCell->cul = cell;
 }
 
 
+/*
+ * Find a cell given its coordinates, wrapping them around when the rows
+ * or the columns form a torus.  Crossing the top or bottom edge moves
+ * the column by the row shift, and crossing the left or right edge
+ * moves the row by the column shift.
+ */
+static Cell *
+wrapCell(int row, int col, int gen)
+{
+	for (;;)
+	{
+		if (wrapRows && (row < 1))
+		{
+			row += rowMax;
+			col += rowShift;
+		}
+		else if (wrapRows && (row > rowMax))
+		{
+			row -= rowMax;
+			col -= rowShift;
+		}
+		else if (wrapCols && (col < 1))
+		{
+			col += colMax;
+			row += colShift;
+		}
+		else if (wrapCols && (col > colMax))
+		{
+			col -= colMax;
+			row -= colShift;
+		}
+		else
+			return findCell(row, col, gen);
+	}
+}
+
+
 /*
  * Find a cell given its coordinates.
  * Most coordinates range from 0 to colMax+1, 0 to rowMax+1, and 0 to genMax-1.
@@ -1562,20 +3933,28 @@ allocateCell(void)
 	Cell *	cell;
 
 	/*
-	 * Allocate a new chunk of cells if there are none left.
+	 * Reuse a cell from an earlier search area if there is one.
+	 * Otherwise allocate a new chunk of cells if there are none left.
 	 */
-	if (newCellCount <= 0)
+	if (usedCellCount < allCellCount)
+		cell = allCells[usedCellCount++];
+	else
 	{
-		newCells = (Cell *) malloc(sizeof(Cell) * ALLOC_SIZE);
+		if (newCellCount <= 0)
+		{
+			newCells = (Cell *) malloc(sizeof(Cell) * ALLOC_SIZE);
 
-		if (newCells == NULL)
-			fatal("Cannot allocate cell structure");
+			if (newCells == NULL)
+				fatal("Cannot allocate cell structure");
 
-		newCellCount = ALLOC_SIZE;
-	}
+			newCellCount = ALLOC_SIZE;
+		}
 
-	newCellCount--;
-	cell = newCells++;
+		newCellCount--;
+		cell = newCells++;
+		allCells[allCellCount++] = cell;
+		usedCellCount++;
+	}
 
 	/*
 	 * If this is the first allocation, then make deadCell be this cell.
@@ -1604,6 +3983,15 @@ allocateCell(void)
 	cell->cd = deadCell;
 	cell->cdr = deadCell;
 	cell->loop = NULL;
+	cell->equal = NULL;
+	cell->equalRank = 0;
+	cell->known = 0;
+	cell->rank = -1;
+	cell->heapPos = 0;
+	cell->activity = 0;
+	cell->valueScore = 0;
+	cell->hint = UNK;
+	cell->phaseIndex = -1;
 
 	return cell;
 }
@@ -1641,6 +4029,86 @@ initImplic(void)
 }
 
 
+/*
+ * Initialize the tables for rules which are not totalistic.  For each
+ * state of a neighborhood, every way of setting its unknown cells is
+ * tried, to see which new states can be made, and which unknown cells
+ * have the same state in every way that makes each new state.
+ */
+static void
+initShapes(void)
+{
+	int		index;
+	int		value;
+	int		on;
+	int		unknown;
+	int		bits;
+	int		i;
+	State		next;
+	Bool		made[2];
+	unsigned int	allOn[2];
+	unsigned int	anyOn[2];
+
+	for (index = 0; index < SHAPE_COUNT; index++)
+	{
+		on = 0;
+		unknown = 0;
+		value = index;
+
+		for (i = 0; i < 9; i++)
+		{
+			if (value % 3 == 1)
+				on |= (1 << i);
+			else if (value % 3 == 2)
+				unknown |= (1 << i);
+
+			value /= 3;
+		}
+
+		for (i = 0; i < 2; i++)
+		{
+			made[i] = FALSE;
+			allOn[i] = 0x1ff;
+			anyOn[i] = 0;
+		}
+
+		/*
+		 * Try every subset of the unknown cells being ON.
+		 */
+		bits = unknown;
+
+		for (;;)
+		{
+			next = ruleTable[on | bits];
+			made[next] = TRUE;
+			allOn[next] &= (on | bits);
+			anyOn[next] |= (on | bits);
+
+			if (bits == 0)
+				break;
+
+			bits = (bits - 1) & unknown;
+		}
+
+		if (made[ON] && made[OFF])
+			shapeTransit[index] = UNK;
+		else
+			shapeTransit[index] = made[ON] ? ON : OFF;
+
+		for (i = 0; i < 2; i++)
+		{
+			shapeImplic[i][index] = 0;
+
+			if (made[i])
+			{
+				shapeImplic[i][index] = (allOn[i] & unknown) |
+					((~anyOn[i] & unknown) << SHAPE_OFF);
+			}
+		}
+	}
+}
+
+
 /*
  * Initialize the transition table.
  */
@@ -1745,6 +4213,7 @@ transition(State state, int offCount, int onCount)
 /*
  * Determine the implications of a cell depending on its known neighbor counts.
  * The unknown neighbor count is implicit since there are eight neighbors.
+ * A rule left undecided by a range of rules could make either state.
  */
 static Flags
 implication(State state, int offCount, int onCount)
@@ -1771,16 +4240,18 @@ implication(State state, int offCount, int onCount)
 			 */
 			next = nextState(OFF, onCount + i);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1IC1;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0IC1;
 
 			next = nextState(ON, onCount + i);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1IC0;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0IC0;
 		}
 	}
@@ -1796,9 +4267,10 @@ implication(State state, int offCount, int onCount)
 			 */
 			next = nextState(OFF, onCount);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1ICUN1;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0ICUN1;
 
 			/*
@@ -1806,9 +4278,10 @@ implication(State state, int offCount, int onCount)
 			 */
 			next = nextState(OFF, onCount + unkCount);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1ICUN0;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0ICUN0;
 		}
 
@@ -1819,9 +4292,10 @@ implication(State state, int offCount, int onCount)
 			 */
 			next = nextState(ON, onCount);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1ICUN1;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0ICUN1;
 
 			/*
@@ -1829,9 +4303,10 @@ implication(State state, int offCount, int onCount)
 			 */
 			next = nextState(ON, onCount + unkCount);
 
-			if (next == ON)
+			if (next != OFF)
 				flags &= ~N1ICUN0;
-			else if (next == OFF)
+
+			if (next != ON)
 				flags &= ~N0ICUN0;
 		}
 
@@ -1841,9 +4316,10 @@ implication(State state, int offCount, int onCount)
 			{
 				next = nextState(OFF, onCount + i);
 
-				if (next == ON)
+				if (next != OFF)
 					flags &= ~(N1ICUN0 | N1ICUN1);
-				else if (next == OFF)
+
+				if (next != ON)
 					flags &= ~(N0ICUN0 | N0ICUN1);
 			}
 
@@ -1851,9 +4327,10 @@ implication(State state, int offCount, int onCount)
 			{
 				next = nextState(ON, onCount + i);
 
-				if (next == ON)
+				if (next != OFF)
 					flags &= ~(N1ICUN0 | N1ICUN1);
-				else if (next == OFF)
+
+				if (next != ON)
 					flags &= ~(N0ICUN0 | N0ICUN1);
 			}
 		}
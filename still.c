@@ -0,0 +1,291 @@
+/*
+ * Life search program - still life search routines.
+ * A still life is only a local condition on its cells, since every cell
+ * in and around it must be made again by the three columns around it.
+ * So when only one generation is being searched, the columns are chosen
+ * from left to right, and the possible columns after the previous two
+ * are looked up instead of being searched for cell by cell.  The search
+ * is depth first, so only the list of possible columns at each column
+ * needs to be kept.
+ */
+
+#include "lifesrc.h"
+
+
+static	RowBits		colBits[COL_MAX + 2];	/* chosen columns */
+static	RowBits		knownBits[COL_MAX + 2];	/* ON cells already known */
+static	RowBits		knownMask[COL_MAX + 2];	/* cells already known */
+static	RowBits *	colList[COL_MAX + 2];	/* possible columns */
+static	int		listCount[COL_MAX + 2];	/* number of possible columns */
+static	int		listMax[COL_MAX + 2];	/* allocated size of lists */
+static	int		listIndex[COL_MAX + 2];	/* possible column being tried */
+static	int		onCount[COL_MAX + 2];	/* ON cells up to each column */
+static	RowBits		allRows;	/* rows which must stay the same */
+static	int		curCol;		/* column being chosen */
+static	Bool		started;	/* search has been started */
+
+
+/*
+ * Local procedures
+ */
+static	void	initStill(void);
+static	void	findList(int);
+static	Bool	closeStill(void);
+static	void	showStill(void);
+
+
+/*
+ * Return whether the still life search can be used instead of the normal
+ * search.  This is so when there is only one generation with few enough
+ * rows for the number of possible columns to stay small, and there are
+ * no options or excluded cells which it does not handle.  The options
+ * which change the search order and hinted cells also select the normal
+ * search, so that they are not ignored.
+ */
+Bool
+stillUsable(void)
+{
+	Cell *	cell;
+	int	row;
+	int	col;
+
+	if ((genMax != 1) || (rowMax > PATTERN_ROWS) || parent ||
+		frontSearch || rowTrans || colTrans ||
+		flipRows || flipCols || flipQuads || rowSym || colSym ||
+		pointSym || fwdSym || bwdSym || symAlias || useEdges ||
+		nearCols || useRow || useCol || dumpFreq || growBox ||
+		wrapRows || wrapCols || ruleRange || (ruleTable[0] == ON))
+	{
+		return FALSE;
+	}
+
+	if (orderWide || orderGens || orderMiddle || orderDynamic ||
+		orderColumns || orderActivity || follow || followGens ||
+		learnValues || restartFreq)
+	{
+		return FALSE;
+	}
+
+	for (row = 1; row <= rowMax; row++)
+	{
+		for (col = 1; col <= colMax; col++)
+		{
+			cell = findCell(row, col, 0);
+
+			if (!cell->choose || (cell->hint != UNK))
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/*
+ * Search for a still life by choosing columns from left to right.
+ * Returns FOUND with the still life set in the cells, or NOT_EXIST
+ * when there are no more choices.  Further calls continue the search.
+ */
+Status
+stillSearch(void)
+{
+	RowBits	bits;
+	int	count;
+
+	if (started)
+		listIndex[curCol]++;
+	else
+	{
+		initStill();
+		started = TRUE;
+	}
+
+	while (curCol > 0)
+	{
+		if (listIndex[curCol] >= listCount[curCol])
+		{
+			curCol--;
+			listIndex[curCol]++;
+			continue;
+		}
+
+		count = onCount[curCol - 1];
+
+		for (bits = colList[curCol][listIndex[curCol]]; bits;
+			bits &= bits - 1)
+		{
+			count++;
+		}
+
+		if (maxCount && (count > maxCount))
+		{
+			listIndex[curCol]++;
+			continue;
+		}
+
+		colBits[curCol] = colList[curCol][listIndex[curCol]];
+		onCount[curCol] = count;
+
+		if (viewFreq && (++viewCount >= viewFreq))
+		{
+			viewCount = 0;
+			ttyStatus("Column %d of %d, %d ON cells\n",
+				curCol, colMax, count);
+		}
+
+		if (ttyCheck())
+			getCommands();
+
+		if (curCol < colMax)
+		{
+			curCol++;
+			findList(curCol);
+			continue;
+		}
+
+		if (closeStill())
+		{
+			showStill();
+
+			return FOUND;
+		}
+
+		listIndex[curCol]++;
+	}
+
+	return NOT_EXIST;
+}
+
+
+/*
+ * Remember the cells of generation 0 which are already known, and start
+ * with the possible first columns.
+ */
+static void
+initStill(void)
+{
+	Cell *	cell;
+	int	row;
+	int	col;
+
+	for (col = 1; col <= colMax; col++)
+	{
+		knownBits[col] = 0;
+		knownMask[col] = 0;
+
+		for (row = 1; row <= rowMax; row++)
+		{
+			cell = findCell(row, col, 0);
+
+			if (cell->state != UNK)
+				knownMask[col] |= (1ULL << row);
+
+			if (cell->state == ON)
+				knownBits[col] |= (1ULL << row);
+		}
+	}
+
+	allRows = (1ULL << (rowMax + 2)) - 1;
+	colBits[0] = 0;
+	onCount[0] = 0;
+	curCol = 1;
+	findList(curCol);
+}
+
+
+/*
+ * Build the list of possible columns for the specified column, given the
+ * two columns before it.  Every cell of the previous column must stay the
+ * same, and the column must agree with the known cells.  As usual, cells
+ * which were set before the search started can break the limits for a
+ * column, but no more ON cells can then be added to it.
+ */
+static void
+findList(int col)
+{
+	const RowBits *	list;
+	RowBits		left;
+	int		count;
+	int		i;
+
+	left = (col > 1) ? colBits[col - 2] : 0;
+
+	list = findColumns(1, &left, &colBits[col - 1], colBits[col - 1],
+		allRows, 0, &count);
+
+	listCount[col] = 0;
+	listIndex[col] = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		if ((list[i] ^ knownBits[col]) & knownMask[col])
+			continue;
+
+		if ((list[i] & ~knownBits[col]) && !columnFits(list[i]))
+			continue;
+
+		if (listCount[col] >= listMax[col])
+		{
+			listMax[col] = listMax[col] * 2 + 64;
+			colList[col] = (RowBits *) realloc(colList[col],
+				listMax[col] * sizeof(RowBits));
+
+			if (colList[col] == NULL)
+				fatal("Cannot allocate column list");
+		}
+
+		colList[col][listCount[col]++] = list[i];
+	}
+}
+
+
+/*
+ * Check that the last column and the empty column after it both stay
+ * the same when the columns beyond them are empty.  An empty column is
+ * always the first of the possible columns when it is one of them.
+ */
+static Bool
+closeStill(void)
+{
+	const RowBits *	list;
+	RowBits		empty;
+	int		count;
+
+	empty = 0;
+
+	list = findColumns(1, &colBits[colMax - 1], &colBits[colMax],
+		colBits[colMax], allRows, 0, &count);
+
+	if ((count == 0) || list[0])
+		return FALSE;
+
+	list = findColumns(1, &colBits[colMax], &empty, empty, allRows, 0,
+		&count);
+
+	return ((count > 0) && (list[0] == 0));
+}
+
+
+/*
+ * Set the cells of generation 0 to the still life which was found.
+ */
+static void
+showStill(void)
+{
+	Cell *	cell;
+	int	row;
+	int	col;
+
+	for (col = 1; col <= colMax; col++)
+	{
+		for (row = 1; row <= rowMax; row++)
+		{
+			cell = findCell(row, col, 0);
+			cell->state = ((colBits[col] >> row) & 1) ? ON : OFF;
+		}
+	}
+
+	cellCount = onCount[colMax];
+}
+
+/* END CODE */